@@ -60,13 +60,23 @@ template<class E> class Buffer
         cond.notify_all();
     }
 
+    //! \brief Push an object into the buffer by moving it
+    //! \details Will block if the capacity has been reached
+    void push(E&& e) {
+        unique_lock<mutex> locker(mux);
+        cond.wait(locker, [this](){return _queue.size() < _capacity;});
+        _queue.push(std::move(e));
+        cond.notify_all();
+    }
+
     //! \brief Pulls an object from the buffer
     //! \details Will block if the capacity is zero
     E pull() {
         unique_lock<mutex> locker(mux);
-        cond.wait(locker, [this](){return not _queue.empty() || _interrupt;});
+        cond.wait(locker, [this](){return not _queue.empty() || _interrupt || _closed;});
+        if (_closed and _queue.empty()) throw BufferInterruptPullingException();
         if (_interrupt and _queue.empty()) { _interrupt = false; throw BufferInterruptPullingException(); }
-        E back = _queue.front();
+        E back = std::move(_queue.front());
         _queue.pop();
         cond.notify_all();
         return back;
@@ -97,12 +107,28 @@ template<class E> class Buffer
         cond.notify_all();
     }
 
+    //! \brief Close the buffer, meaning that no more objects will be pushed
+    //! \details Differently from interrupt_consuming(), the objects still in the buffer are pulled first, and then
+    //! every pull throws, for any number of consumers
+    void close() {
+        lock_guard<mutex> locker(mux);
+        _closed = true;
+        cond.notify_all();
+    }
+
+    //! \brief Whether the buffer has been closed
+    bool is_closed() const {
+        lock_guard<mutex> locker(mux);
+        return _closed;
+    }
+
 private:
     mutable mutex mux;
     condition_variable cond;
     std::queue<E> _queue;
     std::atomic<size_t> _capacity;
     bool _interrupt;
+    bool _closed = false;
 };
 
 } // namespace BetterThreads
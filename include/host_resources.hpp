@@ -0,0 +1,100 @@
+/***************************************************************************
+ *            host_resources.hpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file host_resources.hpp
+ *  \brief Functions for inspecting the computational resources of the host
+ */
+
+#ifndef BETTERTHREADS_HOST_RESOURCES_HPP
+#define BETTERTHREADS_HOST_RESOURCES_HPP
+
+#include "helper/string.hpp"
+
+namespace BetterThreads {
+
+using Helper::String;
+
+//! \brief The number of hardware threads of the host, as given by std::thread::hardware_concurrency()
+//! \details Zero if it cannot be computed
+size_t hardware_concurrency();
+
+//! \brief The number of CPUs the process is allowed to run on according to its affinity mask
+//! \details Supported on Linux only, otherwise equal to hardware_concurrency()
+size_t affinity_concurrency();
+
+//! \brief The number of CPUs from the CPU quota of the control group of the process, rounded up
+//! \details Both cgroup v2 (cpu.max) and cgroup v1 (cpu.cfs_quota_us and cpu.cfs_period_us) are supported, where
+//! the smallest quota along the hierarchy is used. The \a cgroup_root is the mount point of the control groups, while
+//! \a self_cgroup is the file describing the control groups of the process. Zero if no quota is set.
+size_t cgroup_concurrency(String const& cgroup_root = "/sys/fs/cgroup", String const& self_cgroup = "/proc/self/cgroup");
+
+//! \brief The number of CPUs actually usable by the process
+//! \details The minimum between hardware, affinity and control group concurrencies, ignoring those that are zero
+size_t effective_concurrency();
+
+//! \brief Cumulative CPU times of the host, in clock ticks
+struct CpuTimes {
+    //! \brief The time spent not idle
+    unsigned long long int busy = 0;
+    //! \brief The overall time
+    unsigned long long int total = 0;
+};
+
+//! \brief The cumulative CPU times of the host, read from \a proc_stat
+//! \details Zero if not available, as on platforms other than Linux
+CpuTimes cpu_times(String const& proc_stat = "/proc/stat");
+//! \brief The cumulative CPU times from the \a content of a /proc/stat file, using the aggregate cpu line
+CpuTimes parse_cpu_times(String const& content);
+//! \brief The fraction of CPU time spent busy between the \a previous and \a current samples
+//! \details Zero if no time has elapsed
+double cpu_utilisation(CpuTimes const& previous, CpuTimes const& current);
+
+//! \brief The number of scheduling entities of the host currently runnable, read from \a proc_loadavg
+//! \details Zero if not available, as on platforms other than Linux
+size_t runnable_threads(String const& proc_loadavg = "/proc/loadavg");
+//! \brief The number of runnable scheduling entities from the \a content of a /proc/loadavg file
+size_t parse_runnable_threads(String const& content);
+
+//! \brief Register the \a demand of workers of this process into the host-local budget \a file, returning the workers allowed
+//! \details The file, preferably on a shared-memory filesystem such as /dev/shm, holds the demand of each process sharing
+//! the \a budget, with exclusive access granted by a file lock. Processes no longer running are removed. If the
+//! overall demand exceeds the budget, each process is allowed a share of the budget proportional to its demand, with
+//! at least one worker. A zero demand withdraws the process from the file. If the file is not accessible, the demand is allowed.
+size_t share_worker_budget(String const& file, size_t budget, size_t demand);
+
+//! \brief The CPU quota as a number of CPUs, from the \a content of a cgroup v2 cpu.max file
+//! \details Zero if unlimited or not parsable
+double cgroup_v2_cpu_quota(String const& content);
+
+//! \brief The CPU quota as a number of CPUs, from the \a quota_us and \a period_us values of cgroup v1
+//! \details Zero if unlimited, i.e., with a negative quota, or with a non-positive period
+double cgroup_v1_cpu_quota(long long int quota_us, long long int period_us);
+
+} // namespace BetterThreads
+
+#endif // BETTERTHREADS_HOST_RESOURCES_HPP
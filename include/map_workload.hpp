@@ -0,0 +1,218 @@
+/***************************************************************************
+ *            map_workload.hpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file map_workload.hpp
+ *  \brief A workload that maps each element into a result, delivered to an output while processing
+ */
+
+#ifndef BETTERTHREADS_MAP_WORKLOAD_HPP
+#define BETTERTHREADS_MAP_WORKLOAD_HPP
+
+#include <optional>
+#include "workload.hpp"
+#include "buffer.hpp"
+
+namespace BetterThreads {
+
+//! \brief The order in which the results of a MapWorkload are delivered to a buffer or callback
+//! \details ORDERED: in the order of appending of the elements, using a reorder window of bounded size
+//!          UNORDERED: as soon as each result is available
+enum class MapOrdering { ORDERED, UNORDERED };
+
+//! \brief The default number of results that may be held to restore the order of delivery
+const size_t MAP_WORKLOAD_DEFAULT_REORDER_WINDOW = 1024;
+
+//! \brief A static workload where each element is mapped into a result of type R
+//! \details Results are delivered while processing to a Buffer, to a callback or to a vector indexed by the position of
+//! the element in the appending order. With ordered delivery, a thread whose result is more than the reorder window
+//! ahead of the next result to deliver waits for the window to advance, which bounds the results held. The results are
+//! moved to the output, hence R may be move-only; R must be default constructible only when delivering to a vector.
+template<class E, class R, class... AS>
+class MapWorkload : public WorkloadInterface<E,AS...> {
+    using IndexedElement = std::pair<size_t,E>;
+  public:
+    using TaskFunctionType = std::function<R(E const&, AS...)>;
+    using CallbackFunctionType = std::function<void(R&&)>;
+
+    MapWorkload(TaskFunctionType f, AS... as)
+        : _map_func(std::bind(std::forward<TaskFunctionType const>(f), std::placeholders::_1, std::forward<AS>(as)...)),
+          _workload([this](IndexedElement const& ie) { _map(ie); }) { }
+
+    //! \brief Deliver the results to \a buffer
+    //! \details Pushing blocks when the buffer is full, hence the buffer should be pulled while processing
+    void output_to(Buffer<R>& buffer) { output_to([&buffer](R&& r) { buffer.push(std::move(r)); }); }
+    //! \brief Deliver the results to \a callback
+    //! \details With unordered delivery, the callback is called concurrently. With ordered delivery, it is called by one
+    //! thread at a time, without holding any lock of the workload.
+    void output_to(CallbackFunctionType callback) { _indexed_output = nullptr; _resize_indexed_output = nullptr; _sink = std::move(callback); }
+    //! \brief Store each result in \a results at the position of its element, resizing if needed
+    void output_to(std::vector<R>& results) {
+        _sink = nullptr;
+        _indexed_output = &results;
+        // Set here, for R to be required default constructible only when delivering to a vector
+        _resize_indexed_output = [&results](size_t size) { if (results.size() < size) results.resize(size); };
+    }
+
+    //! \brief The order of delivery to a buffer or callback
+    MapOrdering ordering() const { return _ordering; }
+    //! \brief Set the order of delivery to a buffer or callback
+    void set_ordering(MapOrdering ordering) { _ordering = ordering; }
+
+    //! \brief The maximum distance between a result and the next result to deliver, for ordered delivery
+    size_t reorder_window() const { return _reorder_window; }
+    //! \brief Set the maximum distance between a result and the next result to deliver, for ordered delivery
+    void set_reorder_window(size_t window) { HELPER_PRECONDITION(window > 0); _reorder_window = window; }
+
+    //! \brief The number of elements taken from the queue at once by a processing thread
+    size_t chunk_size() const { return _workload.chunk_size(); }
+    //! \brief Set the number of elements taken from the queue at once by a processing thread
+    void set_chunk_size(size_t size) { _workload.set_chunk_size(size); }
+
+    //! \brief Stop processing, discarding the elements not yet processed along with the results not yet delivered
+    void stop() {
+        _workload.stop();
+        lock_guard<mutex> lock(_reorder_mutex);
+        _reorder_condition.notify_all();
+    }
+
+    //! \brief Whether stopping has been requested since the last processing started
+    bool stop_requested() const { return _workload.stop_requested(); }
+
+    void process() override {
+        HELPER_PRECONDITION(_sink or _indexed_output != nullptr);
+        if (_resize_indexed_output) _resize_indexed_output(_next_index);
+        _next_to_deliver = 0;
+        _held_results.clear();
+        _failed = false;
+        _delivering = false;
+        try {
+            _workload.process();
+        } catch (...) {
+            _next_index = 0;
+            throw;
+        }
+        _next_index = 0;
+    }
+
+    size_t size() const override { return _workload.size(); }
+
+    WorkloadInterface<E,AS...>& append(E const& e) override { _workload.emplace(_next_index++, e); return *this; }
+
+    WorkloadInterface<E,AS...>& append(E&& e) override { _workload.emplace(_next_index++, std::move(e)); return *this; }
+
+    WorkloadInterface<E,AS...>& append(List<E> const& es) override { for (auto const& e : es) append(e); return *this; }
+
+  private:
+
+    void _map(IndexedElement const& ie) {
+        try {
+            _deliver(ie.first, _map_func(ie.second));
+        } catch (...) {
+            _fail();
+            _deliver_nothing(ie.first);
+            throw;
+        }
+    }
+
+    void _deliver(size_t index, R&& result) {
+        if (_indexed_output != nullptr) { (*_indexed_output)[index] = std::move(result); return; }
+        if (_ordering == MapOrdering::UNORDERED) { _sink(std::move(result)); return; }
+        unique_lock<mutex> lock(_reorder_mutex);
+        _reorder_condition.wait(lock, [this,index] { return index < _next_to_deliver + _reorder_window or stop_requested() or _failed; });
+        if (stop_requested() or _failed) return;
+        _held_results.emplace(index, std::move(result));
+        _deliver_held(lock);
+    }
+
+    //! \brief Release the threads waiting for the reorder window, since the elements left in the chunk of a failed task are
+    //! discarded without being accounted for
+    void _fail() {
+        lock_guard<mutex> lock(_reorder_mutex);
+        _failed = true;
+        _reorder_condition.notify_all();
+    }
+
+    //! \brief Account for no result at \a index, e.g., due to an exception, for ordered delivery not to wait for it
+    void _deliver_nothing(size_t index) {
+        if (_indexed_output != nullptr or _ordering == MapOrdering::UNORDERED) return;
+        unique_lock<mutex> lock(_reorder_mutex);
+        if (index < _next_to_deliver) return;
+        _held_results.emplace(index, std::nullopt);
+        _deliver_held(lock);
+    }
+
+    //! \brief Deliver the held results that are next in order, with \a lock acquired on the reorder mutex both on entry and on exit
+    //! \details The sink is called with the lock released, by one thread at a time in order to preserve the order: while a
+    //! thread is delivering, the results held by other threads are delivered by it.
+    void _deliver_held(unique_lock<mutex>& lock) {
+        if (_delivering) return;
+        _delivering = true;
+        while (true) {
+            std::vector<R> ready;
+            bool advanced = false;
+            for (auto iter = _held_results.begin(); iter != _held_results.end() and iter->first == _next_to_deliver; iter = _held_results.erase(iter)) {
+                if (iter->second.has_value()) ready.push_back(std::move(*iter->second));
+                ++_next_to_deliver;
+                advanced = true;
+            }
+            if (not advanced) break;
+            _reorder_condition.notify_all();
+            lock.unlock();
+            try {
+                for (auto& result : ready) _sink(std::move(result));
+            } catch (...) {
+                lock.lock();
+                _delivering = false;
+                throw;
+            }
+            lock.lock();
+        }
+        _delivering = false;
+    }
+
+    std::function<R(E const&)> const _map_func;
+    StaticWorkload<IndexedElement> _workload;
+
+    CallbackFunctionType _sink;
+    std::vector<R>* _indexed_output = nullptr;
+    std::function<void(size_t)> _resize_indexed_output; // Resizes the indexed output to at least the given size
+    MapOrdering _ordering = MapOrdering::ORDERED;
+    size_t _reorder_window = MAP_WORKLOAD_DEFAULT_REORDER_WINDOW;
+
+    size_t _next_index = 0; // The position of the next element appended
+    size_t _next_to_deliver = 0; // The position of the next result to deliver, for ordered delivery
+    std::map<size_t,std::optional<R>> _held_results; // Results held for ordered delivery, empty when no result is available
+    bool _failed = false; // Whether a task has thrown during the current processing, guarded by the reorder mutex
+    bool _delivering = false; // Whether a thread is calling the sink for ordered delivery, guarded by the reorder mutex
+    mutex _reorder_mutex;
+    condition_variable _reorder_condition;
+};
+
+} // namespace BetterThreads
+
+#endif // BETTERTHREADS_MAP_WORKLOAD_HPP
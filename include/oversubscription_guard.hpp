@@ -0,0 +1,97 @@
+/***************************************************************************
+ *            oversubscription_guard.hpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file oversubscription_guard.hpp
+ *  \brief Adaptive limitation of the active threads of a pool based on the load of the host
+ */
+
+#ifndef BETTERTHREADS_OVERSUBSCRIPTION_GUARD_HPP
+#define BETTERTHREADS_OVERSUBSCRIPTION_GUARD_HPP
+
+#include <chrono>
+#include <atomic>
+#include "thread_pool.hpp"
+#include "host_resources.hpp"
+#include "using.hpp"
+
+namespace BetterThreads {
+
+const std::chrono::milliseconds OVERSUBSCRIPTION_GUARD_DEFAULT_SAMPLING_INTERVAL = std::chrono::milliseconds(500);
+//! \brief The CPU utilisation of the host above which the host is considered possibly oversubscribed
+const double OVERSUBSCRIPTION_GUARD_UTILISATION_THRESHOLD = 0.9;
+
+//! \brief Periodically samples the load of the host and limits the active threads of a pool when the host is oversubscribed
+//! \details When the CPU utilisation of the host is above OVERSUBSCRIPTION_GUARD_UTILISATION_THRESHOLD, the runnable entities
+//! not belonging to the pool are considered as competing load, and the active threads of the pool are limited to the
+//! \a capacity left, with at least one active thread. Threads in excess are parked, not destroyed. If a budget file is
+//! given, the active threads are further limited by the share of the capacity granted to the process by the file,
+//! which coordinates the processes of the host. The limitation is removed on destruction.
+class OversubscriptionGuard {
+  public:
+    //! \brief Construct for the \a pool, given the \a capacity of the host, the \a sampling_interval and the \a budget_file
+    //! \details An empty \a budget_file disables coordination between processes
+    OversubscriptionGuard(ThreadPool& pool, size_t capacity, std::chrono::milliseconds sampling_interval = OVERSUBSCRIPTION_GUARD_DEFAULT_SAMPLING_INTERVAL,
+                          String const& budget_file = String());
+
+    OversubscriptionGuard(OversubscriptionGuard const&) = delete;
+    void operator=(OversubscriptionGuard const&) = delete;
+
+    //! \brief The interval between samples
+    std::chrono::milliseconds sampling_interval() const;
+    //! \brief The file for coordination between processes, empty if not used
+    String const& budget_file() const;
+
+    //! \brief The number of active threads currently allowed
+    //! \details Equal to THREAD_POOL_UNLIMITED_ACTIVE_THREADS if the pool is not limited
+    size_t allowed_threads() const;
+
+    //! \brief Sample the load and update the active threads of the pool
+    //! \details Called periodically by the sampling thread, but exposed to force an update
+    void update();
+
+    ~OversubscriptionGuard();
+
+  private:
+    ThreadPool& _pool;
+    size_t const _capacity;
+    std::chrono::milliseconds const _sampling_interval;
+    String const _budget_file;
+    std::atomic<size_t> _allowed_threads;
+
+    mutex _update_mutex;
+    CpuTimes _previous_cpu_times;
+
+    bool _stop;
+    mutex _stop_mutex;
+    condition_variable _stop_condition;
+    std::thread _sampling_thread;
+};
+
+} // namespace BetterThreads
+
+#endif // BETTERTHREADS_OVERSUBSCRIPTION_GUARD_HPP
@@ -0,0 +1,394 @@
+/***************************************************************************
+ *            pipeline.hpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file pipeline.hpp
+ *  \brief A pipeline of stages connected by bounded buffers, each stage processed by its own threads
+ */
+
+#ifndef BETTERTHREADS_PIPELINE_HPP
+#define BETTERTHREADS_PIPELINE_HPP
+
+#include <optional>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include "helper/macros.hpp"
+#include "helper/string.hpp"
+#include "templates.hpp"
+#include "buffer.hpp"
+#include "using.hpp"
+
+namespace BetterThreads {
+
+using Helper::String;
+using std::exception_ptr;
+
+//! \brief The parallelism of a stage processing one item at a time, in the order of emission from the source
+const size_t PIPELINE_SERIAL_IN_ORDER = 0;
+//! \brief The default capacity of the buffers connecting the stages
+const size_t PIPELINE_DEFAULT_BUFFER_CAPACITY = 64;
+//! \brief The default maximum number of items emitted by the source and not yet consumed by the sink
+const size_t PIPELINE_DEFAULT_MAX_IN_FLIGHT = 1024;
+
+//! \brief An item flowing through a pipeline, with its position in the order of emission from the source
+//! \details A filtered item has no value, but it still flows to the sink for serial in-order stages not to wait for it
+template<class T> struct PipelineItem {
+    size_t index;
+    std::optional<T> value;
+};
+
+//! \brief The state shared by the stages of a pipeline
+//! \details Bounds the items in flight, which also bounds the items held by serial in-order stages, and records
+//! the first exception thrown by a stage. After an exception or a stop, the items are discarded by the stages.
+class PipelineControl {
+  public:
+    PipelineControl();
+
+    //! \brief Wait until an item can be emitted, returning false if the pipeline has been halted
+    bool acquire_item();
+    //! \brief Account for an item consumed by the sink or discarded
+    void release_item();
+
+    //! \brief Record the exception \a e if it is the first one, halting the pipeline
+    void fail(exception_ptr e);
+    //! \brief Request to halt the pipeline
+    void stop();
+    //! \brief Whether the pipeline has been halted due to an exception or a stop
+    bool halted() const;
+    //! \brief Whether stopping has been requested
+    bool stop_requested() const;
+    //! \brief The first exception thrown by a stage, if any
+    exception_ptr exception() const;
+
+    //! \brief The maximum number of items in flight
+    size_t max_in_flight() const;
+    //! \brief Set the maximum number of items in flight
+    void set_max_in_flight(size_t max);
+
+  private:
+    mutable mutex _mutex;
+    condition_variable _item_availability_condition;
+    size_t _num_in_flight;
+    size_t _max_in_flight;
+    std::atomic<bool> _failed;
+    std::atomic<bool> _stop_requested;
+    exception_ptr _exception;
+};
+
+//! \brief The interface for a stage of a pipeline, regardless of the type of its items
+class PipelineStageInterface {
+  public:
+    //! \brief The name of the stage, used for its threads
+    virtual String const& name() const = 0;
+    //! \brief The number of threads running work()
+    virtual size_t num_workers() const = 0;
+    //! \brief Process the items from the input until exhausted, concurrently with the other workers
+    virtual void work() = 0;
+    //! \brief Notify the next stage that no more items will be produced, called once all the workers are done
+    virtual void close_output() = 0;
+    //! \brief Set the capacity of the buffer to the next stage, if any
+    virtual void set_buffer_capacity(size_t capacity) = 0;
+
+    virtual ~PipelineStageInterface() = default;
+};
+
+//! \brief The source stage, emitting items from a generator until it returns no value
+template<class T> class PipelineSourceStage : public PipelineStageInterface {
+  public:
+    using GeneratorFunctionType = std::function<std::optional<T>()>;
+
+    PipelineSourceStage(String name, GeneratorFunctionType generator, size_t parallelism, PipelineControl& control)
+        : _name(name), _generator(generator), _parallelism(parallelism), _control(control),
+          _output(std::make_shared<Buffer<PipelineItem<T>>>(PIPELINE_DEFAULT_BUFFER_CAPACITY)) { HELPER_PRECONDITION(parallelism > 0); }
+
+    String const& name() const override { return _name; }
+    size_t num_workers() const override { return _parallelism; }
+
+    void work() override {
+        while (not _exhausted and _control.acquire_item()) {
+            std::optional<T> value;
+            try {
+                value = _generator();
+            } catch (...) {
+                _control.release_item();
+                _control.fail(std::current_exception());
+                return;
+            }
+            if (not value.has_value()) {
+                _control.release_item();
+                _exhausted = true;
+                return;
+            }
+            _output->push(PipelineItem<T>{_next_index++, std::move(value)});
+        }
+    }
+
+    void close_output() override { _output->close(); }
+    void set_buffer_capacity(size_t capacity) override { _output->set_capacity(capacity); }
+
+    //! \brief The buffer to the next stage
+    shared_ptr<Buffer<PipelineItem<T>>> const& output() const { return _output; }
+
+  private:
+    String const _name;
+    GeneratorFunctionType const _generator;
+    size_t const _parallelism;
+    PipelineControl& _control;
+    shared_ptr<Buffer<PipelineItem<T>>> const _output;
+    std::atomic<bool> _exhausted = false;
+    std::atomic<size_t> _next_index = 0;
+};
+
+//! \brief A stage pulling items of type I from the previous stage
+//! \details With PIPELINE_SERIAL_IN_ORDER parallelism, one worker handles the items in the order of emission, holding
+//! those arriving early. Items pulled after the pipeline has been halted are discarded.
+template<class I> class PipelineConsumerStage : public PipelineStageInterface {
+  public:
+    PipelineConsumerStage(String name, shared_ptr<Buffer<PipelineItem<I>>> input, size_t parallelism, PipelineControl& control)
+        : _control(control), _name(name), _input(input), _parallelism(parallelism) { }
+
+    String const& name() const override { return _name; }
+    size_t num_workers() const override { return std::max<size_t>(1, _parallelism); }
+
+    void work() override {
+        while (true) {
+            PipelineItem<I> item;
+            try {
+                item = _input->pull();
+            } catch (BufferInterruptPullingException&) {
+                break;
+            }
+            if (_parallelism != PIPELINE_SERIAL_IN_ORDER) { _handle_or_discard(std::move(item)); continue; }
+            _held.emplace(item.index, std::move(item));
+            for (auto iter = _held.begin(); iter != _held.end() and iter->first == _next_index; iter = _held.begin()) {
+                auto node = _held.extract(iter);
+                ++_next_index;
+                _handle_or_discard(std::move(node.mapped()));
+            }
+        }
+        // Items can be left held only if the pipeline has been halted
+        if (_parallelism == PIPELINE_SERIAL_IN_ORDER) {
+            for (size_t i=0; i<_held.size(); ++i) _control.release_item();
+            _held.clear();
+        }
+    }
+
+  protected:
+    //! \brief Handle an \a item, possibly with no value due to filtering
+    virtual void _handle(PipelineItem<I>&& item) = 0;
+
+  private:
+    void _handle_or_discard(PipelineItem<I>&& item) {
+        if (_control.halted()) _control.release_item();
+        else _handle(std::move(item));
+    }
+
+  protected:
+    PipelineControl& _control;
+  private:
+    String const _name;
+    shared_ptr<Buffer<PipelineItem<I>>> const _input;
+    size_t const _parallelism;
+    std::map<size_t,PipelineItem<I>> _held; // Items arrived before the next one in order
+    size_t _next_index = 0; // The index of the next item to handle in order
+};
+
+//! \brief A stage transforming items of type I into items of type O, possibly filtering them out
+template<class I, class O> class PipelineTransformStage : public PipelineConsumerStage<I> {
+  public:
+    using TransformFunctionType = std::function<std::optional<O>(I const&)>;
+
+    PipelineTransformStage(String name, shared_ptr<Buffer<PipelineItem<I>>> input, TransformFunctionType transform, size_t parallelism, PipelineControl& control)
+        : PipelineConsumerStage<I>(name, input, parallelism, control), _transform(transform),
+          _output(std::make_shared<Buffer<PipelineItem<O>>>(PIPELINE_DEFAULT_BUFFER_CAPACITY)) { }
+
+    void close_output() override { _output->close(); }
+    void set_buffer_capacity(size_t capacity) override { _output->set_capacity(capacity); }
+
+    //! \brief The buffer to the next stage
+    shared_ptr<Buffer<PipelineItem<O>>> const& output() const { return _output; }
+
+  protected:
+    void _handle(PipelineItem<I>&& item) override {
+        std::optional<O> result;
+        if (item.value.has_value()) {
+            try {
+                result = _transform(*item.value);
+            } catch (...) {
+                this->_control.release_item();
+                this->_control.fail(std::current_exception());
+                return;
+            }
+        }
+        _output->push(PipelineItem<O>{item.index, std::move(result)});
+    }
+
+  private:
+    TransformFunctionType const _transform;
+    shared_ptr<Buffer<PipelineItem<O>>> const _output;
+};
+
+//! \brief The sink stage, consuming the items of type T that have not been filtered out
+template<class T> class PipelineSinkStage : public PipelineConsumerStage<T> {
+  public:
+    using ConsumeFunctionType = std::function<void(T const&)>;
+
+    PipelineSinkStage(String name, shared_ptr<Buffer<PipelineItem<T>>> input, ConsumeFunctionType consume, size_t parallelism, PipelineControl& control)
+        : PipelineConsumerStage<T>(name, input, parallelism, control), _consume(consume) { }
+
+    void close_output() override { }
+    void set_buffer_capacity(size_t) override { }
+
+  protected:
+    void _handle(PipelineItem<T>&& item) override {
+        if (item.value.has_value()) {
+            try {
+                _consume(*item.value);
+            } catch (...) {
+                this->_control.fail(std::current_exception());
+            }
+        }
+        this->_control.release_item();
+    }
+
+  private:
+    ConsumeFunctionType const _consume;
+};
+
+template<class T> class PipelineBuilder;
+
+//! \brief A pipeline of stages from a source to a sink, connected by bounded buffers
+//! \details Each stage is processed by its own threads, as many as its parallelism, with serial in-order stages being
+//! processed by one thread in the order of emission from the source. A full buffer blocks the stage before it, and the
+//! items in flight are bounded, hence a slow stage slows down the source. The threads of a stage belong to a ThreadPool
+//! of the pipeline, rather than to the ThreadManager, since they block on the buffers for the whole run.
+//! Construct from source(), then add stages with the PipelineBuilder until sink().
+class Pipeline {
+    template<class T> friend class PipelineBuilder;
+  public:
+    //! \brief Start a pipeline with a source stage named \a name calling \a generator from \a parallelism threads
+    //! \details The generator returns an optional value, the source being exhausted when no value is returned.
+    //! With a parallel source, the generator is called concurrently.
+    template<class F> static auto source(String const& name, F generator, size_t parallelism = 1) -> PipelineBuilder<typename ResultOf<F()>::value_type>;
+
+    //! \brief Run the stages until the source is exhausted and the sink has consumed all the items, or until stopped
+    //! \details If a stage throws, the items in flight are discarded and the first exception is rethrown.
+    //! A pipeline can be run only once.
+    void run();
+
+    //! \brief Stop the running pipeline, discarding the items not yet consumed by the sink
+    void stop();
+    //! \brief Whether stopping has been requested
+    bool stop_requested() const;
+
+    //! \brief The number of stages, including source and sink
+    size_t num_stages() const;
+
+    //! \brief The capacity of the buffers connecting the stages
+    size_t buffer_capacity() const;
+    //! \brief Set the capacity of the buffers connecting the stages
+    //! \details Must be set before running
+    void set_buffer_capacity(size_t capacity);
+
+    //! \brief The maximum number of items emitted by the source and not yet consumed by the sink
+    size_t max_in_flight() const;
+    //! \brief Set the maximum number of items emitted by the source and not yet consumed by the sink
+    void set_max_in_flight(size_t max);
+
+  private:
+    //! \brief The shared content of a pipeline, held by the pipeline and its builders
+    struct Content {
+        PipelineControl control;
+        std::vector<shared_ptr<PipelineStageInterface>> stages;
+        size_t buffer_capacity = PIPELINE_DEFAULT_BUFFER_CAPACITY;
+        bool has_run = false;
+    };
+
+    Pipeline(shared_ptr<Content> content);
+
+  private:
+    shared_ptr<Content> _content;
+};
+
+//! \brief A builder for a pipeline whose last stage produces items of type T
+//! \details Only the last stage of a pipeline can be extended, and sink() completes the pipeline
+template<class T> class PipelineBuilder {
+    friend class Pipeline;
+    template<class U> friend class PipelineBuilder;
+  public:
+    //! \brief Add a stage named \a name transforming each item through \a f from \a parallelism threads
+    template<class F> auto map(String const& name, F f, size_t parallelism = 1) -> PipelineBuilder<ResultOf<F(T const&)>> {
+        using R = ResultOf<F(T const&)>;
+        return _add<R>(name, [f](T const& t) { return std::optional<R>(f(t)); }, parallelism);
+    }
+
+    //! \brief Add a stage named \a name keeping the items satisfying \a predicate, checked from \a parallelism threads
+    PipelineBuilder<T> filter(String const& name, std::function<bool(T const&)> predicate, size_t parallelism = 1) {
+        return _add<T>(name, [predicate](T const& t) { return predicate(t) ? std::optional<T>(t) : std::nullopt; }, parallelism);
+    }
+
+    //! \brief Complete the pipeline with a stage named \a name calling \a consume from \a parallelism threads
+    Pipeline sink(String const& name, std::function<void(T const&)> consume, size_t parallelism = 1) {
+        _check_is_last();
+        _content->stages.push_back(std::make_shared<PipelineSinkStage<T>>(name, _output, consume, parallelism, _content->control));
+        return Pipeline(_content);
+    }
+
+  private:
+    PipelineBuilder(shared_ptr<Pipeline::Content> content, shared_ptr<Buffer<PipelineItem<T>>> output)
+        : _content(content), _output(output), _stage_index(content->stages.size()-1) { }
+
+    template<class R> PipelineBuilder<R> _add(String const& name, std::function<std::optional<R>(T const&)> transform, size_t parallelism) {
+        _check_is_last();
+        auto stage = std::make_shared<PipelineTransformStage<T,R>>(name, _output, transform, parallelism, _content->control);
+        _content->stages.push_back(stage);
+        return PipelineBuilder<R>(_content, stage->output());
+    }
+
+    void _check_is_last() const {
+        HELPER_ASSERT_MSG(_stage_index+1 == _content->stages.size(),"Only the last stage of a pipeline can be extended.");
+    }
+
+  private:
+    shared_ptr<Pipeline::Content> const _content;
+    shared_ptr<Buffer<PipelineItem<T>>> const _output;
+    size_t const _stage_index;
+};
+
+template<class F> auto Pipeline::source(String const& name, F generator, size_t parallelism) -> PipelineBuilder<typename ResultOf<F()>::value_type> {
+    using T = typename ResultOf<F()>::value_type;
+    auto content = std::make_shared<Content>();
+    auto stage = std::make_shared<PipelineSourceStage<T>>(name, generator, parallelism, content->control);
+    content->stages.push_back(stage);
+    return PipelineBuilder<T>(content, stage->output());
+}
+
+} // namespace BetterThreads
+
+#endif // BETTERTHREADS_PIPELINE_HPP
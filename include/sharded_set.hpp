@@ -0,0 +1,121 @@
+/***************************************************************************
+ *            sharded_set.hpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file sharded_set.hpp
+ *  \brief A set that is safe for concurrent insertion, split into independently locked shards
+ */
+
+#ifndef BETTERTHREADS_SHARDED_SET_HPP
+#define BETTERTHREADS_SHARDED_SET_HPP
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include "helper/macros.hpp"
+
+namespace BetterThreads {
+
+using std::mutex;
+using std::lock_guard;
+
+//! \brief The default number of shards of a ShardedSet
+const size_t SHARDED_SET_DEFAULT_NUM_SHARDS = 64;
+
+//! \brief A set safe for concurrent access, where each value is stored in the shard chosen by its hash
+//! \details Each shard has its own lock and lies on its own cache line, hence concurrent threads contend only
+//! when accessing values of the same shard.
+template<class T, class H = std::hash<T>, class EQ = std::equal_to<T>>
+class ShardedSet {
+  public:
+    ShardedSet(size_t num_shards = SHARDED_SET_DEFAULT_NUM_SHARDS, H const& hash = H())
+        : _num_shards(num_shards), _hash(hash) {
+        HELPER_PRECONDITION(num_shards > 0);
+        _shards.reset(new Shard[num_shards]);
+        for (size_t i=0; i<num_shards; ++i) _shards[i].values = std::unordered_set<T,H,EQ>(0, hash);
+    }
+
+    //! \brief The number of shards
+    size_t num_shards() const { return _num_shards; }
+
+    //! \brief Insert \a value, returning whether it was not already present
+    bool insert(T const& value) {
+        auto const hash = _hash(value);
+        auto& shard = _shard(hash);
+        lock_guard<mutex> lock(shard.mux);
+        return shard.values.insert(value).second;
+    }
+
+    //! \brief Whether \a value is present
+    bool contains(T const& value) const {
+        auto const hash = _hash(value);
+        auto const& shard = _shard(hash);
+        lock_guard<mutex> lock(shard.mux);
+        return shard.values.contains(value);
+    }
+
+    //! \brief The number of values
+    //! \details Not a consistent snapshot under concurrent insertion
+    size_t size() const {
+        size_t result = 0;
+        for (size_t i=0; i<_num_shards; ++i) {
+            lock_guard<mutex> lock(_shards[i].mux);
+            result += _shards[i].values.size();
+        }
+        return result;
+    }
+
+    //! \brief Remove all values
+    void clear() {
+        for (size_t i=0; i<_num_shards; ++i) {
+            lock_guard<mutex> lock(_shards[i].mux);
+            _shards[i].values.clear();
+        }
+    }
+
+  private:
+
+    struct alignas(64) Shard {
+        mutex mutable mux;
+        std::unordered_set<T,H,EQ> values;
+    };
+
+    //! \brief The shard for a given \a hash, mixed since hashes of integral types are usually the identity
+    Shard& _shard(size_t hash) const {
+        auto const mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+        return _shards[static_cast<size_t>(mixed >> 32) % _num_shards];
+    }
+
+    size_t const _num_shards;
+    H const _hash;
+    std::unique_ptr<Shard[]> _shards;
+};
+
+} // namespace BetterThreads
+
+#endif // BETTERTHREADS_SHARDED_SET_HPP
@@ -52,6 +52,26 @@ using std::future;
 using VoidFunction = std::function<void(void)>;
 using Helper::String;
 
+//! \brief The scheduling class for a thread
+//! \details BATCH and IDLE are supported on Linux only, being ignored elsewhere
+enum class ThreadSchedulingClass { DEFAULT, BATCH, IDLE };
+
+//! \brief Attributes applied to a thread when started
+//! \details Applying the OS name, the scheduling class and the nice level is done on a best-effort basis,
+//! i.e., failures due to platform support or missing privileges are ignored. The default attributes
+//! correspond to the std::thread defaults.
+struct ThreadAttributes {
+    //! \brief The stack size in bytes, where zero uses the system default
+    size_t stack_size = 0;
+    //! \brief Whether to set the OS thread name from the readable name, truncated if required by the platform
+    bool set_os_name = false;
+    //! \brief The scheduling class
+    ThreadSchedulingClass scheduling_class = ThreadSchedulingClass::DEFAULT;
+    //! \brief The nice level to set, where zero leaves the inherited level
+    //! \details Supported on Linux only, where it applies to the thread alone
+    int nice = 0;
+};
+
 //! \brief A class for handling a thread for a pool in a smarter way.
 //! \details It allows to wait for the start of the \a task before extracting the thread id, which is held along with
 //! a readable \a name.
@@ -60,14 +80,18 @@ class Thread {
 
     //! \brief Construct with a \a name and \a active specification
     //! \details The thread will start and store the id if active, otherwise activate() will be needed.
-    Thread(VoidFunction task, String name, bool active);
+    //! An inactive thread does not wait for its id to be available, hence multiple inactive threads can
+    //! be spawned without waiting for each one to start. The \a attributes are applied before running the task.
+    Thread(VoidFunction task, String name, bool active, ThreadAttributes const& attributes = ThreadAttributes());
 
     //! \brief Construct with default active=true and possibly default String name equal to the thread id
     Thread(VoidFunction task, String name = std::string());
 
     //! \brief Get the thread id
+    //! \details Blocks until the thread has started
     thread::id id() const;
     //! \brief Get the readable name
+    //! \details Blocks until the thread has started, since the default name is the id
     String name() const;
 
     //! \brief Activate the thread
@@ -77,15 +101,27 @@ class Thread {
     //! \brief The exception, if it exists
     exception_ptr const& exception() const;
 
+    //! \brief The attributes applied to the thread
+    ThreadAttributes const& attributes() const;
+
     //! \brief Destroy the instance
     ~Thread();
 
+  private:
+    //! \brief Start the thread running the \a body, using a native thread if a custom stack size is required
+    void _start(VoidFunction body);
+    //! \brief Apply the attributes from within the thread
+    void _apply_attributes() const;
+
   private:
     String _name;
+    ThreadAttributes const _attributes;
     thread::id _id;
     std::thread _thread;
+    bool _uses_native_thread; // Whether the thread has been created natively, since std::thread does not support a custom stack size
+    std::thread::native_handle_type _native_thread;
     promise<void> _got_id_promise;
-    future<void> _got_id_future;
+    std::shared_future<void> _got_id_future;
     std::atomic<bool> _active;
     promise<void> _ready_for_task_promise;
     future<void> _ready_for_task_future;
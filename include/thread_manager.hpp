@@ -34,9 +34,13 @@
 #define BETTERTHREADS_THREAD_MANAGER_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
 #include "conclog/logging.hpp"
 #include "conclog/thread_registry_interface.hpp"
 #include "thread_pool.hpp"
+#include "oversubscription_guard.hpp"
 #include "templates.hpp"
 
 namespace BetterThreads {
@@ -45,6 +49,9 @@ using ConcLog::ThreadRegistryInterface;
 using ConcLog::Logger;
 
 //! \brief Manages threads based on concurrency availability.
+//! \details Tasks are run on a default pool, whose concurrency is the one set with set_concurrency(), but additional named
+//! pools can be added, e.g., for blocking I/O tasks not to reduce the concurrency available to compute tasks. The overall
+//! concurrency of all the pools cannot exceed the maximum concurrency.
 class ThreadManager : public ThreadRegistryInterface {
   private:
     ThreadManager();
@@ -64,52 +71,137 @@ class ThreadManager : public ThreadRegistryInterface {
     }
 
     //! \brief Whether threads have already been registered
+    //! \details Does not lock, since called by the Logger while printing from any thread
     bool has_threads_registered() const override;
 
     //! \brief Get the maximum concurrency allowed by this machine
+    //! \details This is the effective concurrency, accounting for the CPU affinity of the process and the CPU quota of its control group
     size_t maximum_concurrency() const;
+    //! \brief Get the raw concurrency of the hardware, regardless of affinity or quota
+    size_t hardware_concurrency() const;
     //! \brief Get the preferred concurrency to be used
     //! \details A concurrency of zero is allowed, meaning that a task
     //! will be run sequentially
     size_t concurrency() const;
+    //! \brief Get the concurrency summed over all the pools
+    size_t total_concurrency() const;
 
     //! \brief Synchronised method for updating the preferred concurrency to be used
+    //! \details Fails if the total concurrency would exceed the maximum concurrency
     void set_concurrency(size_t value);
 
+    //! \brief Add a pool with the given \a name, \a concurrency and thread \a attributes
+    //! \details Fails if a pool with the same name exists, or if the total concurrency would exceed the maximum concurrency.
+    //! The threads of the pool are named after the pool.
+    void add_pool(String const& name, size_t concurrency = 0, ThreadAttributes const& attributes = ThreadAttributes());
+    //! \brief Whether a pool with the given \a name exists
+    //! \details The default pool is named THREAD_POOL_DEFAULT_NAME
+    bool has_pool(String const& name) const;
+    //! \brief The concurrency of the pool with the given \a name
+    size_t pool_concurrency(String const& name) const;
+    //! \brief Set the concurrency of the pool with the given \a name
+    //! \details Fails if the total concurrency would exceed the maximum concurrency
+    void set_pool_concurrency(String const& name, size_t value);
+
     //! \brief Set the concurrency to the maximum allowed by this machine
+    //! \details The threads of the named pools are subtracted, for the total concurrency not to exceed the maximum
     void set_maximum_concurrency();
 
+    //! \brief Enable the adaptive concurrency, which limits the active threads of the default pool when the host is oversubscribed
+    //! \details The load of the host is sampled every \a sampling_interval. If a \a budget_file is given, e.g., under /dev/shm,
+    //! the processes using the same file share the maximum concurrency as a global budget of workers. Threads in excess are
+    //! parked, not destroyed. If already enabled, the previous settings are replaced.
+    void enable_adaptive_concurrency(std::chrono::milliseconds sampling_interval = OVERSUBSCRIPTION_GUARD_DEFAULT_SAMPLING_INTERVAL,
+                                     String const& budget_file = String());
+    //! \brief Disable the adaptive concurrency, removing any limitation on the active threads
+    void disable_adaptive_concurrency();
+    //! \brief Whether the adaptive concurrency is enabled
+    bool has_adaptive_concurrency() const;
+    //! \brief The number of threads of the default pool currently allowed to take tasks
+    //! \details Lower than concurrency() only if the adaptive concurrency limits the active threads
+    size_t active_concurrency() const;
+
+    //! \brief Set the queue size of the default pool from which tasks are executed in the calling thread, if all the threads are busy
+    //! \details Use THREAD_POOL_CALLER_RUNS_DISABLED to always queue the tasks
+    void set_caller_runs_threshold(size_t threshold);
+    //! \brief Execute a task queued on the default pool in the calling thread, returning whether a task was available
+    //! \details For threads waiting on tasks they enqueued, so that nesting cannot exhaust the pool. The task may be
+    //! unrelated to the ones waited for, and delay the waiting thread for as long as it runs.
+    bool run_pending_task();
+
+    //! \brief Set whether threads are activated only when queued tasks outnumber the idle threads
+    void set_lazy_thread_activation(bool lazy);
+    //! \brief Set the attributes of the threads spawned from now on
+    void set_thread_attributes(ThreadAttributes const& attributes);
+    //! \brief Set the time after which a thread parked by reducing the concurrency is retired
+    //! \details Parked threads are revived when increasing the concurrency, keeping their id and name
+    void set_thread_parking_timeout(std::chrono::milliseconds timeout);
+
     //! \brief Set the Logger scheduler to the immediate one
-    //! \details Fails if the concurrency is not zero
+    //! \details Fails if the total concurrency is not zero
     void set_logging_immediate_scheduler() const;
     //! \brief Set the Logger scheduler to the blocking one
-    //! \details Fails if the concurrency is not zero
+    //! \details Fails if the total concurrency is not zero
     void set_logging_blocking_scheduler() const;
     //! \brief Set the Logger scheduler to the nonblocking one
-    //! \details Fails if the concurrency is not zero
+    //! \details Fails if the total concurrency is not zero
     void set_logging_nonblocking_scheduler() const;
 
     //! \brief Enqueue a task for execution, returning the future handler
     //! \details The is no limits on the number of tasks to enqueue. If concurrency is zero,
-    //! then the task is executed sequentially with no threads involved
+    //! then the task is executed sequentially with no threads involved. The same happens if
+    //! all the threads are busy and the queue size has reached the caller-runs threshold.
     template<class F, class... AS> auto enqueue(F &&f, AS &&... args) -> future<ResultOf<F(AS...)>>;
 
+    //! \brief Enqueue a task for execution on the pool with the given \a name, returning the future handler
+    //! \details If the concurrency of the pool is zero, then the task is executed sequentially with no threads involved
+    template<class F, class... AS> auto enqueue_on(String const& name, F &&f, AS &&... args) -> future<ResultOf<F(AS...)>>;
+
+  private:
+    //! \brief The pool with the given \a name, with the lock on the concurrency already acquired
+    shared_ptr<ThreadPool> const& _pool_at(String const& name) const;
+    //! \brief Check that the total concurrency does not exceed the maximum when changing the pool with the given \a name
+    //! to \a value, with the lock on the concurrency already acquired, returning the total concurrency
+    size_t _check_total_concurrency(String const& name, size_t value) const;
+    //! \brief Execute a task sequentially with no threads involved
+    template<class F, class... AS> static auto _execute_sequentially(F &&f, AS &&... args) -> future<ResultOf<F(AS...)>>;
+
   private:
+    const size_t _hardware_concurrency;
     const size_t _maximum_concurrency;
     size_t _concurrency;
+    std::atomic<size_t> _total_concurrency; // The concurrency summed over all the pools, read without locking
     mutable mutex _concurrency_mutex;
+    mutex _resizing_mutex; // Serialises the changes to the number of threads of the pools, held while they complete
 
     ThreadPool _pool;
+    std::map<String,shared_ptr<ThreadPool>> _named_pools; // The additional pools
+    std::unique_ptr<OversubscriptionGuard> _oversubscription_guard; // Declared after the default pool in order to be destroyed before it
+    mutable mutex _oversubscription_guard_mutex;
 };
 
+template<class F, class... AS> auto ThreadManager::_execute_sequentially(F &&f, AS &&... args) -> future<ResultOf<F(AS...)>> {
+    using ReturnType = ResultOf<F(AS...)>;
+    auto task = packaged_task<ReturnType()>(std::bind(std::forward<F>(f), std::forward<AS>(args)...));
+    future<ReturnType> result = task.get_future();
+    task();
+    return result;
+}
+
 template<class F, class... AS> auto ThreadManager::enqueue(F &&f, AS &&... args) -> future<ResultOf<F(AS...)>> {
-    if (_concurrency == 0) {
-        using ReturnType = ResultOf<F(AS...)>;
-        auto task = packaged_task<ReturnType()>(std::bind(std::forward<F>(f), std::forward<AS>(args)...));
-        future<ReturnType> result = task.get_future();
-        task();
-        return result;
-    } else return _pool.enqueue(f,args...);
+    if (_concurrency == 0) return _execute_sequentially(std::forward<F>(f), std::forward<AS>(args)...);
+    else return _pool.enqueue(f,args...);
+}
+
+template<class F, class... AS> auto ThreadManager::enqueue_on(String const& name, F &&f, AS &&... args) -> future<ResultOf<F(AS...)>> {
+    if (name == _pool.name()) return enqueue(std::forward<F>(f), std::forward<AS>(args)...);
+    shared_ptr<ThreadPool> pool;
+    {
+        lock_guard<mutex> lock(_concurrency_mutex);
+        pool = _pool_at(name);
+    }
+    if (pool->num_threads() == 0) return _execute_sequentially(std::forward<F>(f), std::forward<AS>(args)...);
+    else return pool->enqueue(f,args...);
 }
 
 } // namespace BetterThreads
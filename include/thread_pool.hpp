@@ -34,6 +34,8 @@
 #define BETTERTHREADS_THREAD_POOL_HPP
 
 #include <queue>
+#include <limits>
+#include <chrono>
 #include "conclog/logging.hpp"
 #include "helper/container.hpp"
 #include "thread.hpp"
@@ -46,20 +48,41 @@ using std::make_shared;
 using Helper::List;
 
 const String THREAD_POOL_DEFAULT_NAME = "thr";
+const size_t THREAD_POOL_UNBOUNDED_QUEUE_CAPACITY = std::numeric_limits<size_t>::max();
+const size_t THREAD_POOL_CALLER_RUNS_DISABLED = std::numeric_limits<size_t>::max();
+const size_t THREAD_POOL_UNLIMITED_ACTIVE_THREADS = std::numeric_limits<size_t>::max();
+const std::chrono::milliseconds THREAD_POOL_DEFAULT_PARKING_TIMEOUT = std::chrono::seconds(60);
 
 //! \brief Exception for stopping a thread pool
 class StoppedThreadPoolException : public std::exception { };
 
+//! \brief Exception for enqueueing on a full queue when using the FAIL policy
+class FullThreadPoolQueueException : public std::exception { };
+
+//! \brief The policy to apply when a task is enqueued while the queue is at capacity
+//! \details BLOCK: wait until a worker extracts a task from the queue
+//!          FAIL: throw a FullThreadPoolQueueException
+//!          CALLER_RUNS: execute the task in the calling thread
+//!          DROP_OLDEST: discard the oldest task in the queue, whose future will hold a broken promise
+enum class QueueFullPolicy { BLOCK, FAIL, CALLER_RUNS, DROP_OLDEST };
+
 //! \brief A pool of Thread objects managed internally given a (variable) number of threads
-//! \details Differently from managing a single BufferedThread, the task queue for a pool is not upper-bounded, i.e., BufferedThread
-//! objects use a buffer of one element, which receives once the wrapped task that consumes elements from the task queue.
+//! \details Differently from managing a single BufferedThread, the task queue for a pool is not upper-bounded by default, i.e., BufferedThread
+//! objects use a buffer of one element, which receives once the wrapped task that consumes elements from the task queue. A capacity
+//! can be set on the queue, in which case the QueueFullPolicy decides what to do with a task enqueued when the capacity is reached.
+//! When the number of threads is reduced, the threads in excess are parked instead of being destroyed, so that they can be revived
+//! by a later increase: a thread parked for longer than the parking timeout is retired. Threads can also be parked temporarily
+//! by setting a maximum number of active threads lower than the number of threads.
 class ThreadPool {
   public:
     //! \brief Construct from a given number of threads and possibly a name
-    ThreadPool(size_t num_threads, String name = THREAD_POOL_DEFAULT_NAME);
+    //! \details With \a lazy_activation, threads are spawned but activated only when the queued tasks outnumber the idle threads.
+    //! The thread \a attributes are applied to all the threads spawned.
+    ThreadPool(size_t num_threads, String name = THREAD_POOL_DEFAULT_NAME, bool lazy_activation = false, ThreadAttributes const& attributes = ThreadAttributes());
 
     //! \brief Enqueue a task for execution, returning the future handler
-    //! \details The is no limits on the number of tasks to enqueue
+    //! \details If the queue capacity is reached, the queue full policy is applied. If the pool is saturated according
+    //! to the caller-runs threshold, the task is executed in the calling thread.
     template<class F, class... AS> auto enqueue(F &&f, AS &&... args) -> future<ResultOf<F(AS...)>>;
 
     //! \brief The name of the pool
@@ -67,16 +90,70 @@ class ThreadPool {
 
     //! \brief The size of the tasks queue
     size_t queue_size() const;
+    //! \brief Execute the oldest queued task in the calling thread, returning whether a task was available
+    //! \details Allows a thread waiting on tasks of the same pool to help instead of blocking a worker. The task may be
+    //! unrelated to the ones waited for, and delay the waiting thread for as long as it runs.
+    bool run_pending_task();
+    //! \brief The capacity of the tasks queue
+    size_t queue_capacity() const;
+    //! \brief Change the queue capacity
+    //! \details Capacity cannot be changed to a value lower than the current size
+    void set_queue_capacity(size_t capacity);
+
+    //! \brief The policy applied when enqueueing on a full queue
+    QueueFullPolicy queue_full_policy() const;
+    //! \brief Change the policy applied when enqueueing on a full queue
+    void set_queue_full_policy(QueueFullPolicy policy);
+
+    //! \brief The queue size from which a task is executed in the calling thread, if all the threads are busy
+    //! \details Equal to THREAD_POOL_CALLER_RUNS_DISABLED if tasks are always queued
+    size_t caller_runs_threshold() const;
+    //! \brief Set the queue size from which a task is executed in the calling thread, if all the threads are busy
+    //! \details Running the task in the caller caps the queue size and keeps the caller busy with useful work
+    void set_caller_runs_threshold(size_t threshold);
 
     //! \brief The number of threads
+    //! \details Parked threads are not accounted for
     size_t num_threads() const;
+    //! \brief The number of threads that have been activated
+    //! \details Equal to num_threads() unless using lazy activation
+    size_t num_activated_threads() const;
+    //! \brief The number of threads currently executing a task
+    size_t num_busy_threads() const;
+    //! \brief The number of threads currently parked
+    size_t num_parked_threads() const;
 
     //! \brief Set the number of threads
     //! \details If reducing the current number, this method will block until
-    //! all the previous tasks are completed, previous threads are destroyed
-    //! and new threads are spawned
+    //! the threads in excess have completed their current task and have been parked.
+    //! If increasing, parked threads are revived before new threads are spawned.
     void set_num_threads(size_t number);
 
+    //! \brief The maximum number of threads that can take tasks
+    size_t max_active_threads() const;
+    //! \brief Set the maximum number of threads that can take tasks
+    //! \details Threads in excess are parked after completing their current task, without retiring and without waiting
+    //! for them to park, hence this method does not block
+    void set_max_active_threads(size_t number);
+
+    //! \brief The time after which a parked thread is retired
+    std::chrono::milliseconds parking_timeout() const;
+    //! \brief Set the time after which a parked thread is retired
+    //! \details Applies to threads parked from now on
+    void set_parking_timeout(std::chrono::milliseconds timeout);
+
+    //! \brief The attributes of the threads spawned
+    ThreadAttributes thread_attributes() const;
+    //! \brief Set the attributes of the threads spawned
+    //! \details Applies to threads spawned from now on, hence not to parked threads when revived
+    void set_thread_attributes(ThreadAttributes const& attributes);
+
+    //! \brief Whether threads are activated only on demand
+    bool lazy_activation() const;
+    //! \brief Set whether threads are activated only on demand
+    //! \details If disabling, all threads not activated yet are activated
+    void set_lazy_activation(bool lazy);
+
     ~ThreadPool();
 
   private:
@@ -84,23 +161,59 @@ class ThreadPool {
     //! \brief The function wrapper handling the extraction from the queue
     //! \details Takes \a i as the index of the thread in the list, for identification when stopping selectively
     VoidFunction _task_wrapper_function(size_t i);
+    //! \brief The number of threads that can take tasks, with the lock on the tasks queue already acquired
+    size_t _num_usable_threads() const { return std::min(_num_threads_to_use, _max_active_threads); }
+    //! \brief Park the thread of index \a i, with \a lock already acquired on the tasks queue
+    //! \details Returns whether the thread has been revived, otherwise it has been retired or the pool is stopping
+    bool _park(size_t i, unique_lock<mutex>& lock);
     //! \brief Append threads in the given range
+    //! \details All threads are first spawned and then activated, unless using lazy activation
     void _append_thread_range(size_t lower, size_t upper);
+    //! \brief Activate the first thread not activated yet
+    void _activate_next_thread();
+    //! \brief Activate as many threads as required for the queued tasks to be taken by an idle thread
+    void _activate_threads_on_demand();
+    //! \brief Activate threads on demand, or leave the activation pending for the current holder of the lock on the number of threads
+    //! \details The lock is not waited for, since a task enqueueing while the number of threads is reduced would deadlock
+    void _try_activate_threads_on_demand();
+    //! \brief Release the \a lock on the number of threads, then perform any activation left pending meanwhile
+    void _unlock_num_threads(unique_lock<mutex>& lock);
+    //! \brief Destroy the threads from index \a number onwards
+    //! \details The threads must not be running tasks, i.e., they must be retired or not activated
+    void _remove_threads_from(size_t number);
+    //! \brief Apply the queue full policy if the capacity has been reached, with \a lock already acquired on the tasks queue
+    //! \details Returns whether the task must instead be run by the caller, in which case the lock is released
+    bool _apply_queue_full_policy(unique_lock<mutex>& lock);
+    //! \brief Check whether the pool is saturated according to the caller-runs threshold, with \a lock already acquired on the tasks queue
+    //! \details Returns whether the task must instead be run by the caller, in which case the lock is released
+    bool _apply_caller_runs_policy(unique_lock<mutex>& lock);
 
   private:
     const String _name;
     List<shared_ptr<Thread>> _threads;
     std::queue<VoidFunction> _tasks;
+    size_t _queue_capacity;
+    QueueFullPolicy _queue_full_policy;
+    size_t _caller_runs_threshold;
+    std::atomic<bool> _lazy_activation;
+    std::chrono::milliseconds _parking_timeout;
+    ThreadAttributes _thread_attributes;
 
     mutable mutex _task_availability_mutex;
     condition_variable _task_availability_condition;
+    condition_variable _task_space_condition; // Notified when a task is extracted from a bounded queue
+    condition_variable _revival_condition; // Notified when parked threads may be revived or retired
+    condition_variable _parking_completion_condition; // Notified when a thread has been parked
     bool _finish_all_and_stop; // Wait till the queue is empty before stopping the thread, used for destruction
-    size_t _num_active_threads; // Down-counter for checking whether all the threads to stop have been stopped
-    size_t _num_threads_to_use; // Reference on the number of threads to use: if lower than the threads size, the last threads will stop
-    mutable mutex _num_active_threads_mutex;
+    size_t _num_idle_threads; // Activated threads not executing a task, used for activation on demand
+    size_t _num_busy_threads; // Threads executing a task
+    size_t _num_parked_threads; // Threads waiting to be revived or retired
+    size_t _num_live_threads; // Threads not retired, always a prefix of the threads list
+    std::atomic<size_t> _num_activated_threads; // The threads activated so far, in order of index, changed with the lock on the number of threads
+    size_t _num_threads_to_use; // Reference on the number of threads to use: if lower than the threads size, the last threads will park
+    size_t _max_active_threads; // Threads beyond this number are parked, but not retired
+    std::atomic<bool> _activation_pending; // Whether an activation on demand could not acquire the lock on the number of threads
     mutable mutex _num_threads_mutex;
-    promise<void> _all_unused_threads_stopped_promise;
-    future<void> _all_unused_threads_stopped_future;
 };
 
 template<class F, class... AS>
@@ -112,9 +225,14 @@ auto ThreadPool::enqueue(F &&f, AS &&... args) -> future<ResultOf<F(AS...)>> {
     {
         unique_lock<mutex> lock(_task_availability_mutex);
         if (_finish_all_and_stop) throw StoppedThreadPoolException();
+        if (_apply_queue_full_policy(lock) or _apply_caller_runs_policy(lock)) {
+            (*task)();
+            return result;
+        }
         _tasks.emplace([task]{ (*task)(); });
     }
     _task_availability_condition.notify_one();
+    if (_lazy_activation) _try_activate_threads_on_demand();
     return result;
 }
 
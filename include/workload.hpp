@@ -33,14 +33,21 @@
 #ifndef BETTERTHREADS_WORKLOAD_HPP
 #define BETTERTHREADS_WORKLOAD_HPP
 
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <iomanip>
+#include <map>
+#include <thread>
+#include <vector>
 #include "helper/container.hpp"
-#include "helper/tuple.hpp"
 #include "conclog/progress_indicator.hpp"
 #include "workload_interface.hpp"
 #include "thread_manager.hpp"
 #include "workload_advancement.hpp"
+#include "sharded_set.hpp"
+#include "workload_statistics.hpp"
+#include "workload_concurrency_tuner.hpp"
 
 namespace BetterThreads {
 
@@ -49,13 +56,46 @@ using ConcLog::LogScopeManager;
 using ConcLog::Logger;
 
 using Helper::List;
-using Helper::make_lpair;
 
 using std::mutex;
 using std::unique_lock;
 using std::lock_guard;
 using std::condition_variable;
 
+//! \brief The chunk size value for which the size is adapted from the measured cost of the elements
+const size_t WORKLOAD_ADAPTIVE_CHUNK_SIZE = 0;
+//! \brief The intended processing duration of a chunk, when the chunk size is adaptive
+const std::chrono::microseconds WORKLOAD_ADAPTIVE_CHUNK_DURATION = std::chrono::microseconds(200);
+//! \brief The default minimum interval between two renderings of the progress of a workload
+//! \details Also limits the calls to the progress acknowledge function, which used to be called for each element
+const std::chrono::milliseconds WORKLOAD_DEFAULT_PROGRESS_INTERVAL = std::chrono::milliseconds(100);
+//! \brief The minimum interval over which the throughput is measured when auto-tuning the concurrency of a workload
+const std::chrono::milliseconds WORKLOAD_AUTO_TUNING_SAMPLING_INTERVAL = std::chrono::milliseconds(50);
+
+//! \brief The order in which the elements appended during processing are scheduled
+//! \details FIFO: all elements go to the shared queue, hence they are processed breadth-first
+//!          LIFO: elements appended by a processing thread are kept by the thread and processed depth-first
+//!          BOUNDED_BREADTH: as FIFO, but as LIFO while the shared queue holds at least the breadth bound
+//! Elements kept by a thread are donated in part to the shared queue when the latter becomes empty, for other threads to work on.
+enum class WorkloadSchedulingPolicy { FIFO, LIFO, BOUNDED_BREADTH };
+
+//! \brief The default size of the shared queue from which elements are processed depth-first, for the bounded-breadth policy
+const size_t WORKLOAD_DEFAULT_BREADTH_BOUND = 1024;
+
+//! \brief What to do with an element appended by a task when the shared queue is beyond its pending budget
+//! \details BLOCK: the appending task waits for the queue to shrink; if all the processing threads are blocked appending,
+//!          the element is kept by the appending thread and processed depth-first, without growing the queue
+//!          INLINE: the element is processed right away by the appending thread
+enum class WorkloadAdmissionPolicy { BLOCK, INLINE };
+
+//! \brief The pending budget value for no limit
+const size_t WORKLOAD_UNLIMITED_PENDING = std::numeric_limits<size_t>::max();
+
+//! \brief Counter of the process() calls of all workloads, used to tell them apart
+inline std::atomic<size_t> workload_process_generations = 0;
+//! \brief The process() call whose logger level has been last imposed to the current thread
+inline thread_local size_t workload_synchronised_generation = 0;
+
 //! \brief Base class implementation
 template<class E, class... AS>
 class WorkloadBase : public WorkloadInterface<E,AS...> {
@@ -64,69 +104,324 @@ class WorkloadBase : public WorkloadInterface<E,AS...> {
   public:
     using TaskFunctionType = std::function<void(E const &)>;
     using ProgressAcknowledgeFunctionType = std::function<void(E const &, shared_ptr<ProgressIndicator>)>;
-    using CompletelyBoundFunctionType = std::function<void(void)>;
 
     void process() override {
         _log_scope_manager.reset(new LogScopeManager(HELPER_PRETTY_FUNCTION,0));
         _logger_level = Logger::instance().current_level();
+        _generation = ++workload_process_generations;
+        workload_synchronised_generation = _generation;
+        unique_lock<mutex> lock(_element_availability_mutex);
+        _processing = true;
+        _stop_requested = false;
+        _concurrency = ThreadManager::instance().concurrency();
+        _statistics.start(_concurrency+1);
+        _start_auto_tuning();
+        _caller_waiting = true;
+        _spawn_drainers(lock);
         while (true) {
-            unique_lock<mutex> lock(_element_availability_mutex);
-            _element_availability_condition.wait(lock, [=,this] { return _advancement.has_finished() or not _sequential_queue.empty() or _exception != nullptr; });
-            if (_exception != nullptr) rethrow_exception(_exception);
-            if (_advancement.has_finished()) { _log_scope_manager.reset(); return; }
-
-            CompletelyBoundFunctionType task, progress_acknowledge;
-            make_lpair(task,progress_acknowledge) = _sequential_queue.front();
-            _sequential_queue.pop();
-            if (_using_concurrency()) {
-                ThreadManager::instance().enqueue([this, task, progress_acknowledge] { _concurrent_task_wrapper(task, progress_acknowledge); });
-            } else {
-                _advancement.add_to_processing();
-                if (not Logger::instance().is_muted_at(0)) { progress_acknowledge(); _print_hold(); }
-                task();
-                _advancement.add_to_completed();
-            }
+            _caller_waiting = true;
+            _wait_claiming(lock, [this] { return _exception != nullptr or not _queue.empty() or (_advancement.has_finished() and _num_drainers == 0); });
+            _caller_waiting = false;
+            if (_exception != nullptr or _queue.empty()) break;
+            _process_chunk(lock);
+        }
+        // Drainers still reference this object, hence we cannot leave before they are done
+        _wait_claiming(lock, [this] { return _num_drainers == 0; });
+        _processing = false;
+        _statistics.finish();
+        _log_scope_manager.reset();
+        if (_exception != nullptr) {
+            auto exception = _exception;
+            _exception = nullptr;
+            _discard_queue();
+            rethrow_exception(exception);
         }
     }
 
-    size_t size() const override { return _sequential_queue.size(); }
+    size_t size() const override { lock_guard<mutex> lock(_element_availability_mutex); return _queue.size(); }
+
+    WorkloadInterface<E,AS...>& append(E const& e) override { return emplace(e); }
 
-    WorkloadInterface<E,AS...>& append(E const& e) override {
+    WorkloadInterface<E,AS...>& append(E&& e) override { return emplace(std::move(e)); }
+
+    WorkloadInterface<E,AS...>& append(List<E> const& es) override { for (auto const& e : es) append(e); return *this; }
+
+    //! \brief Append one element to process, constructed in place from \a args
+    template<class... ES> WorkloadInterface<E,AS...>& emplace(ES&&... args) {
         _advancement.add_to_waiting();
-        _sequential_queue.push(std::make_pair(std::bind(std::forward<TaskFunctionType const>(_task_func), std::forward<E const&>(e)),
-                                                   std::bind(std::forward<ProgressAcknowledgeFunctionType const>(_progress_acknowledge_func), std::forward<E const&>(e),
-                                                  _progress_indicator)
-                         ));
+        _queue.emplace_back(std::forward<ES>(args)...);
+        if (_size_func) _pending_bytes += _size_func(_queue.back());
+        if (_priority) std::push_heap(_queue.begin(), _queue.end(), _priority);
+        _queue_empty = false;
         return *this;
     }
 
-    WorkloadInterface<E,AS...>& append(List<E> const& es) override { for (auto e : es) append(e); return *this; }
+    //! \brief The number of elements taken from the queue at once by a processing thread
+    //! \details Equal to WORKLOAD_ADAPTIVE_CHUNK_SIZE if adapted from the measured cost of the elements
+    size_t chunk_size() const { lock_guard<mutex> lock(_element_availability_mutex); return _chunk_size; }
+    //! \brief Set the number of elements taken from the queue at once by a processing thread
+    //! \details Chunks reduce the synchronisation overhead for fine-grained elements, at the expense of load balancing.
+    //! With WORKLOAD_ADAPTIVE_CHUNK_SIZE, chunks are sized to last about WORKLOAD_ADAPTIVE_CHUNK_DURATION, while
+    //! leaving at least one chunk to each processing thread.
+    void set_chunk_size(size_t size) { lock_guard<mutex> lock(_element_availability_mutex); _chunk_size = size; }
+
+    //! \brief The minimum interval between two renderings of the progress
+    std::chrono::nanoseconds progress_interval() const { return std::chrono::nanoseconds(_progress_interval.load()); }
+    //! \brief Set the minimum interval between two renderings of the progress
+    //! \details Only the element processed by the thread that renders acknowledges its progress, hence the
+    //! progress acknowledge function is called at most once per interval, WORKLOAD_DEFAULT_PROGRESS_INTERVAL by default.
+    //! A zero interval renders and acknowledges for each element, as before rate limiting was introduced.
+    void set_progress_interval(std::chrono::nanoseconds interval) { _progress_interval = interval.count(); }
+
+    //! \brief The statistics of the current processing, or of the last one if not processing
+    WorkloadStatistics statistics() const {
+        lock_guard<mutex> lock(_element_availability_mutex);
+        return _statistics.statistics(_advancement.waiting()+_advancement.processing());
+    }
+
+    //! \brief Whether the progress rendering shows the throughput and ETA
+    bool shows_statistics() const { return _show_statistics; }
+    //! \brief Set whether the progress rendering shows the throughput and ETA
+    void set_show_statistics(bool show) { _show_statistics = show; }
+
+    //! \brief Whether the number of processing threads is tuned for the best throughput
+    bool auto_tunes_concurrency() const { return _auto_tuning; }
+    //! \brief Set whether the number of processing threads is tuned for the best throughput
+    //! \details The throughput of completed elements is measured at a number of threads at a time, from the calling one
+    //! up to the concurrency of the ThreadManager plus the calling one, and hill-climbed until settling on the best number;
+    //! a lower number is preferred when the throughput is flat. The best number found is the starting one of the next
+    //! processing, even if not settled yet. Takes effect from the next processing.
+    void set_auto_tune_concurrency(bool auto_tune) { _auto_tuning = auto_tune; }
+    //! \brief The number of processing threads, including the calling one, used by the auto-tuning
+    //! \details Zero if auto-tuning has never been used
+    size_t tuned_concurrency() const {
+        lock_guard<mutex> lock(_element_availability_mutex);
+        return _tuner.level();
+    }
+
+    //! \brief Stop processing, discarding the elements not yet processed
+    //! \details The elements under processing are completed, with their tasks able to check stop_requested() to return early.
+    //! Has effect only during processing.
+    void stop() {
+        lock_guard<mutex> lock(_element_availability_mutex);
+        if (not _processing) return;
+        _stop_requested = true;
+        _discard_queue();
+        _element_availability_condition.notify_one();
+    }
+
+    //! \brief Whether stopping has been requested since the last processing started
+    bool stop_requested() const { return _stop_requested.load(std::memory_order_relaxed); }
 
   private:
 
-    bool _using_concurrency() const { return ThreadManager::instance().concurrency() > 0; }
+    //! \brief Discard the elements in the queue, accounting them as completed, with the lock acquired
+    void _discard_queue() {
+        size_t const size = _queue.size();
+        if (size == 0) return;
+        _advancement.add_to_processing(size);
+        _advancement.add_to_completed(size);
+        _queue.clear();
+        _queue_empty = true;
+        _pending_bytes = 0;
+        _admission_condition.notify_all();
+    }
 
-    void _concurrent_task_wrapper(CompletelyBoundFunctionType const& task, CompletelyBoundFunctionType const& progress_acknowledge) {
-        _advancement.add_to_processing();
-        if (_logger_level > Logger::instance().current_level()) Logger::instance().increase_level(_logger_level-Logger::instance().current_level());
-        else Logger::instance().decrease_level(Logger::instance().current_level()-_logger_level);
+    //! \brief Enqueue to the ThreadManager enough drainers to cover the queue, within the concurrency available
+    //! \details Requires \a lock to be acquired, which is released while enqueueing since a drainer may be run by this thread
+    void _spawn_drainers(unique_lock<mutex>& lock) {
+        size_t const concurrency = _drainers_limit();
+        size_t const uncovered = _queue.size() - (_caller_waiting and not _queue.empty() ? 1 : 0);
+        if (_num_drainers >= concurrency or uncovered == 0) return;
+        size_t const num_to_spawn = std::min(concurrency - _num_drainers, uncovered);
+        _num_drainers += num_to_spawn;
+        std::vector<shared_ptr<std::atomic<bool>>> tickets;
+        for (size_t i=0; i<num_to_spawn; ++i) tickets.push_back(std::make_shared<std::atomic<bool>>(false));
+        _pending_drainers.insert(_pending_drainers.end(), tickets.begin(), tickets.end());
+        // The processing thread may be waiting for the drainers, and must claim the new ones if they do not start
+        _element_availability_condition.notify_one();
+        lock.unlock();
+        for (auto const& ticket : tickets)
+            ThreadManager::instance().enqueue([this, ticket] { if (not ticket->exchange(true)) _drain(); });
+        lock.lock();
+    }
+
+    //! \brief Claim the drainers not yet started by the ThreadManager, with the lock acquired
+    //! \details A claimed drainer returns without accessing this object when run, hence it is not waited for
+    void _claim_pending_drainers() {
+        for (auto const& ticket : _pending_drainers)
+            if (not ticket->exchange(true)) --_num_drainers;
+        _pending_drainers.clear();
+    }
+
+    //! \brief Wait on the element availability until \a predicate holds, with \a lock acquired both on entry and on exit
+    //! \details Waiting only happens when the queue is empty, hence the drainers not yet started have nothing to process:
+    //! they are claimed instead of waited for, since they may be queued behind tasks whose workers are waiting themselves,
+    //! as with nested workloads. No other task of the ThreadManager is run by this thread.
+    template<class P> void _wait_claiming(unique_lock<mutex>& lock, P predicate) {
+        while (not predicate()) {
+            _claim_pending_drainers();
+            if (predicate()) return;
+            _element_availability_condition.wait(lock);
+        }
+    }
+
+    //! \brief Process elements from the queue until empty, then retire
+    void _drain() {
+        unique_lock<mutex> lock(_element_availability_mutex);
+        if (workload_synchronised_generation != _generation) {
+            _synchronise_logger_level();
+            workload_synchronised_generation = _generation;
+        }
+        while (_exception == nullptr and not _queue.empty() and _num_drainers <= _drainers_limit())
+            _process_chunk(lock);
+        --_num_drainers;
+        if (_num_blocked_appenders > 0) _admission_condition.notify_all();
+        // Notified under lock, since the object may be destroyed as soon as the processing thread acquires it
+        _element_availability_condition.notify_one();
+    }
+
+    //! \brief The number of elements to take from the queue, with the lock acquired
+    size_t _next_chunk_size() const {
+        if (_chunk_size != WORKLOAD_ADAPTIVE_CHUNK_SIZE) return std::min(_chunk_size, _queue.size());
+        size_t const fair_size = std::max<size_t>(1, _queue.size()/(_num_drainers+1));
+        if (_element_cost_estimate <= 0.0) return 1;
+        auto const target_size = static_cast<size_t>(static_cast<double>(WORKLOAD_ADAPTIVE_CHUNK_DURATION.count())/_element_cost_estimate);
+        return std::clamp<size_t>(target_size, 1, fair_size);
+    }
+
+    //! \brief Process a chunk of elements from the front of the queue, with \a lock acquired both on entry and on exit
+    //! \details The elements kept by the current thread while processing an element of the chunk are processed
+    //! right after it. After an exception, the remaining elements are discarded.
+    void _process_chunk(unique_lock<mutex>& lock) {
+        size_t const size = _next_chunk_size();
+        std::vector<E> chunk;
+        chunk.reserve(size);
+        for (size_t i=0; i<size; ++i) chunk.push_back(_take_next());
+        _queue_empty = _queue.empty();
+        _advancement.add_to_processing(size);
+        if (_num_blocked_appenders > 0) _admission_condition.notify_all();
+        bool const donate = (_num_drainers > 0 or _concurrency > 0);
+        lock.unlock();
+
+        std::vector<E> kept;
+        auto const previous_worker_stack = _worker_stack;
+        _worker_stack = {this, &kept};
+        exception_ptr exception;
+        size_t num_processed = 0;
+        bool const print_hold = not Logger::instance().is_muted_at(0);
+        auto const start = std::chrono::steady_clock::now();
+        for (auto const& e : chunk) {
+            exception = _run(e, print_hold);
+            ++num_processed;
+            if (exception == nullptr) _process_kept(kept, print_hold, donate, exception, num_processed);
+            if (exception != nullptr or stop_requested()) break;
+        }
+        auto const end = std::chrono::steady_clock::now();
+        auto const duration = end-start;
+        _worker_stack = previous_worker_stack;
+
+        lock.lock();
+        _advancement.add_to_completed(size);
+        if (_num_blocked_appenders > 0) _admission_condition.notify_all();
+        // Elements skipped after stopping or after an exception are completed without being processed
+        _statistics.record(duration, num_processed, end);
+        double const element_cost = std::chrono::duration<double,std::micro>(duration).count()/static_cast<double>(num_processed);
+        _element_cost_estimate = (_element_cost_estimate <= 0.0 ? element_cost : 0.75*_element_cost_estimate + 0.25*element_cost);
+        if (exception != nullptr and _exception == nullptr) _exception = exception;
+        if (_tuning) _sample_throughput(lock);
+    }
 
-        if (not Logger::instance().is_muted_at(0)) { progress_acknowledge(); _print_hold(); }
+    //! \brief The maximum number of drainers, with the lock acquired
+    //! \details When auto-tuning, drainers in excess retire after their current chunk
+    size_t _drainers_limit() const {
+        return (_tuning ? std::min(_concurrency, _tuner.level()-1) : _concurrency);
+    }
+
+    //! \brief Start the auto-tuning of the concurrency if enabled, with the lock acquired
+    void _start_auto_tuning() {
+        _tuning = _auto_tuning;
+        if (not _tuning) return;
+        _tuner.start(std::min(_concurrency, ThreadManager::instance().maximum_concurrency())+1);
+        _sampling_start = std::chrono::steady_clock::now();
+        _sampling_completed = _advancement.completed();
+    }
+
+    //! \brief Record the throughput for auto-tuning if the sampling interval has elapsed, with \a lock acquired both on entry and on exit
+    //! \details The sample also requires at least one element completed per thread, for slow elements to be measured reliably
+    void _sample_throughput(unique_lock<mutex>& lock) {
+        if (_tuner.settled()) return;
+        auto const now = std::chrono::steady_clock::now();
+        size_t const num_completed = _advancement.completed() - _sampling_completed;
+        if (now - _sampling_start < WORKLOAD_AUTO_TUNING_SAMPLING_INTERVAL or num_completed < _tuner.level()) return;
+        size_t const previous_level = _tuner.level();
+        _tuner.record(static_cast<double>(num_completed)/std::chrono::duration<double>(now - _sampling_start).count());
+        _sampling_start = now;
+        _sampling_completed += num_completed;
+        if (_tuner.level() > previous_level) _spawn_drainers(lock);
+    }
+
+    //! \brief Remove the next element from the queue, with the lock acquired
+    E _take_next() {
+        if (_priority) std::pop_heap(_queue.begin(), _queue.end(), _priority);
+        E result = std::move(_priority ? _queue.back() : _queue.front());
+        if (_priority) _queue.pop_back();
+        else _queue.pop_front();
+        if (_size_func) _pending_bytes -= _size_func(result);
+        return result;
+    }
+
+    //! \brief Run the task on element \a e, returning the exception thrown if any
+    exception_ptr _run(E const& e, bool print_hold) {
+        if (print_hold and _claim_progress_rendering()) { _progress_acknowledge_func(e, _progress_indicator); _print_hold(); }
         try {
-            task();
+            _task_func(e);
         } catch (...) {
-            {
-                lock_guard<mutex> lock(_element_availability_mutex);
-                _exception = std::current_exception();
-            }
-            _element_availability_condition.notify_one();
+            return std::current_exception();
         }
+        return nullptr;
+    }
 
-        {
-            lock_guard<mutex> lock(_element_availability_mutex);
+    //! \brief Process depth-first the elements \a kept by the current thread, possibly donating the oldest ones when the queue is empty
+    void _process_kept(std::vector<E>& kept, bool print_hold, bool donate, exception_ptr& exception, size_t& num_processed) {
+        while (not kept.empty() and exception == nullptr and not stop_requested()) {
+            if (donate and kept.size() > 1 and _queue_empty.load(std::memory_order_relaxed)) _donate(kept);
+            E e = std::move(kept.back());
+            kept.pop_back();
+            _advancement.add_to_processing();
+            exception = _run(e, print_hold);
             _advancement.add_to_completed();
+            ++num_processed;
+        }
+        if (not kept.empty()) {
+            _advancement.add_to_processing(kept.size());
+            _advancement.add_to_completed(kept.size());
+            kept.clear();
+        }
+    }
+
+    //! \brief Move the older half of the elements \a kept by the current thread to the queue, if still empty
+    //! \details The elements moved are limited by the pending budget
+    void _donate(std::vector<E>& kept) {
+        unique_lock<mutex> lock(_element_availability_mutex);
+        if (not _queue.empty()) return;
+        auto const half = kept.begin() + static_cast<std::ptrdiff_t>(kept.size()/2);
+        auto iter = kept.begin();
+        for (; iter != half and not _exceeds_pending_budget(); ++iter) {
+            if (_size_func) _pending_bytes += _size_func(*iter);
+            _queue.push_back(std::move(*iter));
         }
-        if (_advancement.has_finished()) { _element_availability_condition.notify_one(); }
+        if (_priority) std::make_heap(_queue.begin(), _queue.end(), _priority);
+        kept.erase(kept.begin(), iter);
+        _queue_empty = false;
+        _element_availability_condition.notify_one();
+        _spawn_drainers(lock);
+    }
+
+    //! \brief Impose the logger level of the processing thread to the current thread
+    void _synchronise_logger_level() const {
+        if (_logger_level > Logger::instance().current_level()) Logger::instance().increase_level(_logger_level-Logger::instance().current_level());
+        else Logger::instance().decrease_level(Logger::instance().current_level()-_logger_level);
     }
 
     void _default_progress_acknowledge(E const& e, shared_ptr<ProgressIndicator> indicator) {
@@ -134,6 +429,14 @@ class WorkloadBase : public WorkloadInterface<E,AS...> {
         indicator->update_final(static_cast<double>(_advancement.total()));
     }
 
+    //! \brief Whether the current thread is the one to render the progress, due to the interval having elapsed
+    bool _claim_progress_rendering() {
+        auto const now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto last = _last_progress_rendering.load(std::memory_order_relaxed);
+        if (last != NEVER_RENDERED and now - last < _progress_interval.load(std::memory_order_relaxed)) return false;
+        return _last_progress_rendering.compare_exchange_strong(last, now, std::memory_order_relaxed);
+    }
+
     void _print_hold() {
         std::ostringstream logger_stream;
         logger_stream << "[" << _progress_indicator->symbol() << "] " << _progress_indicator->percentage() << "% ";
@@ -141,51 +444,138 @@ class WorkloadBase : public WorkloadInterface<E,AS...> {
                       << " p="<<std::setw(2)<<std::left<<_advancement.processing()
                       << " c="<<std::setw(3)<<std::left<<_advancement.completed()
                       << ")";
+        if (_show_statistics) logger_stream << " " << progress_summary(this->statistics());
         Logger::instance().hold(_log_scope_manager->scope(),logger_stream.str());
     }
 
   protected:
 
-    void _enqueue(E const& e) {
-        if (_using_concurrency()) {
-            _advancement.add_to_waiting();
-            auto task = std::bind(std::forward<TaskFunctionType const>(_task_func), std::forward<E const&>(e));
-            auto progress_acknowledge = std::bind(std::forward<ProgressAcknowledgeFunctionType const>(_progress_acknowledge_func),
-                                                  std::forward<E const&>(e), _progress_indicator);
-            ThreadManager::instance().enqueue([this,task,progress_acknowledge]{ _concurrent_task_wrapper(task, progress_acknowledge); });
-        } else {
-            // Locking and notification are used when concurrency is set to zero during processing, in order to avoid a race and to resume processing _sequential_queue respectively
-            {
-                lock_guard<mutex> lock(_element_appending_mutex);
-                append(e);
+    //! \brief Append an element during processing, constructed from \a args
+    //! \details Depending on the scheduling policy, the element is either kept by the appending thread or sent to the
+    //! queue, spawning a drainer for it if concurrency allows
+    template<class... ES> void _enqueue(ES&&... args) {
+        if (stop_requested()) return;
+        auto const policy = _scheduling_policy.load(std::memory_order_relaxed);
+        bool const by_processing_thread = (_worker_stack.owner == this);
+        if (by_processing_thread and policy == WorkloadSchedulingPolicy::LIFO) { _keep(std::forward<ES>(args)...); return; }
+        unique_lock<mutex> lock(_element_availability_mutex);
+        if (_stop_requested) return;
+        if (by_processing_thread and policy == WorkloadSchedulingPolicy::BOUNDED_BREADTH and _queue.size() >= _breadth_bound.load(std::memory_order_relaxed)) {
+            lock.unlock();
+            _keep(std::forward<ES>(args)...);
+            return;
+        }
+        if (by_processing_thread and _exceeds_pending_budget()) {
+            if (_admission_policy == WorkloadAdmissionPolicy::INLINE) {
+                lock.unlock();
+                _run_inline(E(std::forward<ES>(args)...));
+                return;
+            }
+            ++_num_blocked_appenders;
+            // Proceeding anyway only if the drainers and the calling thread are all blocked, since nobody would shrink the queue
+            _admission_condition.wait(lock, [this] { return not _exceeds_pending_budget() or _num_blocked_appenders > _num_drainers or _stop_requested or _exception != nullptr; });
+            --_num_blocked_appenders;
+            if (_stop_requested or _exception != nullptr) return;
+            if (_exceeds_pending_budget()) {
+                lock.unlock();
+                _keep(std::forward<ES>(args)...);
+                return;
             }
-            _element_availability_condition.notify_one();
         }
+        emplace(std::forward<ES>(args)...);
+        _element_availability_condition.notify_one();
+        _spawn_drainers(lock);
+    }
+
+    //! \brief Whether the queue has reached the pending limit or the pending byte budget, with the lock acquired
+    bool _exceeds_pending_budget() const {
+        return _queue.size() >= _pending_limit or (_size_func and _pending_bytes >= _pending_byte_budget);
+    }
+
+    //! \brief Process element \a e in the current thread, within the processing of another element
+    //! \details An exception is rethrown to the task of the other element
+    void _run_inline(E const& e) {
+        _advancement.add_to_waiting();
+        _advancement.add_to_processing();
+        auto const exception = _run(e, not Logger::instance().is_muted_at(0));
+        _advancement.add_to_completed();
+        if (exception != nullptr) rethrow_exception(exception);
+    }
+
+    //! \brief Keep an element constructed from \a args in the current processing thread
+    template<class... ES> void _keep(ES&&... args) {
+        _advancement.add_to_waiting();
+        _worker_stack.elements->emplace_back(std::forward<ES>(args)...);
     }
 
   protected:
 
+    // Queue of elements, each stored once and drained both by the processing thread and by drainers in the ThreadManager
+    std::deque<E> _queue;
+    mutex mutable _element_availability_mutex;
+
+    // Optional ordering of the queue as a heap, where the element with the highest priority compares greater than the others
+    std::function<bool(E const&, E const&)> _priority;
+
+    std::atomic<WorkloadSchedulingPolicy> _scheduling_policy = WorkloadSchedulingPolicy::FIFO;
+    std::atomic<size_t> _breadth_bound = WORKLOAD_DEFAULT_BREADTH_BOUND;
+
+    // Budget for the elements in the queue, checked when appending from a task
+    WorkloadAdmissionPolicy _admission_policy = WorkloadAdmissionPolicy::BLOCK;
+    size_t _pending_limit = WORKLOAD_UNLIMITED_PENDING;
+    size_t _pending_byte_budget = WORKLOAD_UNLIMITED_PENDING;
+    std::function<size_t(E const&)> _size_func; // The size in bytes of an element, if a byte budget is used
+    size_t _pending_bytes = 0;
+    size_t _num_blocked_appenders = 0; // The threads waiting for the queue to shrink in order to append
+    condition_variable _admission_condition;
+
     TaskFunctionType _task_func;
     ProgressAcknowledgeFunctionType _progress_acknowledge_func;
     WorkloadAdvancement _advancement;
 
   private:
 
-    // Queue of task-progress_acknowledge pairs for initial consumption and for consumption when using no concurrency
-    std::queue<std::pair<CompletelyBoundFunctionType,CompletelyBoundFunctionType>> _sequential_queue;
+    std::atomic<bool> _queue_empty = true; // Whether the queue is empty, for threads to check without locking
+    std::atomic<bool> _stop_requested = false;
+    bool _processing = false; // Whether process() is running, with the lock acquired
+    size_t _concurrency = 0; // The concurrency of the ThreadManager when processing started, not to lock it for each chunk
+    size_t _num_drainers = 0; // The drainers enqueued to the ThreadManager and not yet retired
+    std::vector<shared_ptr<std::atomic<bool>>> _pending_drainers; // The tickets of the drainers possibly not started, set when started or claimed
+    bool _caller_waiting = false; // Whether the processing thread is waiting for elements to process
+    size_t _chunk_size = 1; // The number of elements taken from the queue at once
+    double _element_cost_estimate = 0.0; // Moving average of the processing time of an element, in microseconds
+    WorkloadStatisticsRecorder _statistics;
+    std::atomic<bool> _show_statistics = false;
+    std::atomic<bool> _auto_tuning = false; // Whether to auto-tune the concurrency from the next processing
+    bool _tuning = false; // Whether the concurrency is auto-tuned in the current processing
+    WorkloadConcurrencyTuner _tuner;
+    std::chrono::steady_clock::time_point _sampling_start; // The start of the current throughput sample
+    size_t _sampling_completed = 0; // The elements completed at the start of the current throughput sample
+
+    static constexpr std::chrono::nanoseconds::rep NEVER_RENDERED = std::numeric_limits<std::chrono::nanoseconds::rep>::min();
+    std::atomic<std::chrono::nanoseconds::rep> _progress_interval = std::chrono::nanoseconds(WORKLOAD_DEFAULT_PROGRESS_INTERVAL).count();
+    std::atomic<std::chrono::nanoseconds::rep> _last_progress_rendering = NEVER_RENDERED; // Time of the last rendering, in nanoseconds of the steady clock
 
     unsigned int _logger_level; // The logger level to impose to the running threads
+    size_t _generation = 0; // The identifier of the current process() call, for threads to impose the logger level only once
     shared_ptr<LogScopeManager> _log_scope_manager; // The scope manager required to properly hold print
     shared_ptr<ProgressIndicator> _progress_indicator; // The progress indicator to hold print
 
-    mutex _element_appending_mutex;
-    mutex _element_availability_mutex;
     condition_variable _element_availability_condition;
 
     exception_ptr _exception;
+
+    // The elements kept by the current thread while processing an element of the owner workload
+    struct WorkerStack {
+        WorkloadBase const* owner = nullptr;
+        std::vector<E>* elements = nullptr;
+    };
+    static inline thread_local WorkerStack _worker_stack;
 };
 
 //! \brief A basic static workload where all elements are appended and then processed
+//! \details Differently from DynamicWorkload, the task receives no access to the workload: a task can stop the
+//! processing by calling stop() on a workload captured by reference, e.g., in a lambda.
 template<class E, class... AS>
 class StaticWorkload : public WorkloadBase<E,AS...> {
 public:
@@ -196,6 +586,81 @@ public:
     }
 };
 
+//! \brief A static workload whose elements are reduced into a value of type R
+//! \details Each processing thread accumulates into a private accumulator, initialised with the identity value and
+//! aligned to a cache line. The accumulators are combined once, when processing completes.
+template<class E, class R, class... AS>
+class ReducingWorkload : public WorkloadBase<E,AS...> {
+  public:
+    using TaskFunctionType = std::function<void(E const&, R&, AS...)>;
+    using CombineFunctionType = std::function<void(R&, R const&)>;
+
+    //! \brief Construct from the task \a f that accumulates an element into an R, the \a identity value
+    //! for the accumulators and the \a combine function to accumulate one R into another
+    ReducingWorkload(TaskFunctionType f, R identity, CombineFunctionType combine, AS... as) : WorkloadBase<E, AS...>(), _identity(identity), _combine(combine), _result(identity) {
+        auto accumulating_task = std::bind(std::forward<TaskFunctionType const>(f), std::placeholders::_1, std::placeholders::_2, std::forward<AS>(as)...);
+        this->_task_func = [this, accumulating_task](E const& e) { accumulating_task(e, _accumulator()); };
+    }
+
+    //! \brief Process the elements until completion, then combine the accumulators into the result
+    void process() override {
+        {
+            lock_guard<mutex> lock(_accumulators_mutex);
+            _accumulators.clear();
+            _thread_accumulators.clear();
+            _epoch = ++workload_process_generations;
+        }
+        WorkloadBase<E,AS...>::process();
+        R result = _identity;
+        for (auto const& accumulator : _accumulators) _combine(result, accumulator.value);
+        _result = std::move(result);
+    }
+
+    //! \brief The result of the last processing
+    R const& result() const { return _result; }
+
+    //! \brief Process the elements until completion and return the result
+    R reduce() { process(); return _result; }
+
+  private:
+
+    //! \brief The accumulator of the current thread, cached to avoid locking for each element
+    R& _accumulator() {
+        auto& cache = _accumulator_cache;
+        if (cache.owner != this or cache.epoch != _epoch) {
+            lock_guard<mutex> lock(_accumulators_mutex);
+            auto iter = _thread_accumulators.find(std::this_thread::get_id());
+            if (iter == _thread_accumulators.end()) {
+                _accumulators.push_back(Accumulator{_identity});
+                iter = _thread_accumulators.emplace(std::this_thread::get_id(), &_accumulators.back().value).first;
+            }
+            cache = {this, _epoch, iter->second};
+        }
+        return *cache.value;
+    }
+
+    struct alignas(64) Accumulator {
+        R value;
+    };
+
+    R const _identity;
+    CombineFunctionType const _combine;
+    R _result;
+
+    std::deque<Accumulator> _accumulators; // Stable storage for the accumulators
+    std::map<std::thread::id,R*> _thread_accumulators;
+    // Unique across workloads for each processing, to invalidate the cached accumulators even if another workload reuses the same address
+    std::atomic<size_t> _epoch = 0;
+    mutex _accumulators_mutex;
+
+    struct AccumulatorCache {
+        ReducingWorkload const* owner = nullptr;
+        size_t epoch = 0;
+        R* value = nullptr;
+    };
+    static inline thread_local AccumulatorCache _accumulator_cache;
+};
+
 //! \brief A dynamic workload in which it is possible to append new elements from the called function
 template<class E, class... AS>
 class DynamicWorkload : public WorkloadBase<E,AS...> {
@@ -206,7 +671,16 @@ class DynamicWorkload : public WorkloadBase<E,AS...> {
     protected:
         Access(DynamicWorkload& parent) : _load(parent) { }
     public:
-        void append(E const &e) { _load._enqueue(e); }
+        void append(E const &e) { if (_load._admits(e)) _load._enqueue(e); }
+        void append(E&& e) { if (_load._admits(e)) _load._enqueue(std::move(e)); }
+        template<class... ES> void emplace(ES&&... args) {
+            if (_load._admission) append(E(std::forward<ES>(args)...));
+            else _load._enqueue(std::forward<ES>(args)...);
+        }
+        //! \brief Stop processing, e.g., when a result has been found
+        void stop() { _load.stop(); }
+        //! \brief Whether stopping has been requested, for long tasks to return early
+        bool stop_requested() const { return _load.stop_requested(); }
     private:
         DynamicWorkload& _load;
     };
@@ -222,10 +696,103 @@ class DynamicWorkload : public WorkloadBase<E,AS...> {
         this->_progress_acknowledge_func = p;
     }
 
+    //! \brief The order in which the elements appended during processing are scheduled
+    WorkloadSchedulingPolicy scheduling_policy() const { return this->_scheduling_policy; }
+    //! \brief Set the order in which the elements appended during processing are scheduled
+    void set_scheduling_policy(WorkloadSchedulingPolicy policy) { this->_scheduling_policy = policy; }
+
+    //! \brief The maximum number of elements in the shared queue before applying the admission policy
+    size_t pending_limit() const { lock_guard<mutex> lock(this->_element_availability_mutex); return this->_pending_limit; }
+    //! \brief Set the maximum number of elements in the shared queue before applying the admission policy
+    void set_pending_limit(size_t limit) {
+        HELPER_PRECONDITION(limit > 0);
+        lock_guard<mutex> lock(this->_element_availability_mutex);
+        this->_pending_limit = limit;
+    }
+
+    //! \brief The maximum bytes of the elements in the shared queue before applying the admission policy
+    size_t pending_byte_budget() const { lock_guard<mutex> lock(this->_element_availability_mutex); return this->_pending_byte_budget; }
+    //! \brief Set the maximum bytes of the elements in the shared queue, as measured by \a size_func, before applying the admission policy
+    //! \details To be set when not processing
+    void set_pending_byte_budget(size_t budget, std::function<size_t(E const&)> size_func) {
+        HELPER_PRECONDITION(budget > 0);
+        lock_guard<mutex> lock(this->_element_availability_mutex);
+        this->_pending_byte_budget = budget;
+        this->_size_func = size_func;
+        this->_pending_bytes = 0;
+        for (auto const& e : this->_queue) this->_pending_bytes += size_func(e);
+    }
+
+    //! \brief What to do with an element appended by a task when the shared queue is beyond its pending budget
+    WorkloadAdmissionPolicy admission_policy() const { lock_guard<mutex> lock(this->_element_availability_mutex); return this->_admission_policy; }
+    //! \brief Set what to do with an element appended by a task when the shared queue is beyond its pending budget
+    void set_admission_policy(WorkloadAdmissionPolicy policy) { lock_guard<mutex> lock(this->_element_availability_mutex); this->_admission_policy = policy; }
+
+    //! \brief The size of the shared queue from which elements are processed depth-first, for the bounded-breadth policy
+    size_t breadth_bound() const { return this->_breadth_bound; }
+    //! \brief Set the size of the shared queue from which elements are processed depth-first, for the bounded-breadth policy
+    void set_breadth_bound(size_t bound) { HELPER_PRECONDITION(bound > 0); this->_breadth_bound = bound; }
+
+  protected:
+    //! \brief Whether an element appended by a task is to be processed, according to the admission function if any
+    bool _admits(E const& e) const { return not _admission or _admission(e); }
+
+    std::function<bool(E const&)> _admission; // Optional filter of the elements appended by tasks
+
   private:
     Access const _access;
 };
 
+//! \brief A dynamic workload that processes the elements with the highest priority first
+//! \details As with std::priority_queue, the next element is the greatest according to Compare. Elements appended by
+//! tasks enter the same ordering, unless a depth-first scheduling policy keeps them in the appending thread.
+template<class E, class Compare, class... AS>
+class PriorityWorkload : public DynamicWorkload<E,AS...> {
+  public:
+    using typename DynamicWorkload<E,AS...>::TaskFunctionType;
+    using typename DynamicWorkload<E,AS...>::ProgressAcknowledgeFunctionType;
+
+    PriorityWorkload(Compare compare, ProgressAcknowledgeFunctionType p, TaskFunctionType t, AS... as)
+        : DynamicWorkload<E,AS...>(p, t, as...) {
+        this->_priority = compare;
+    }
+
+    PriorityWorkload(ProgressAcknowledgeFunctionType p, TaskFunctionType t, AS... as)
+        : PriorityWorkload(Compare(), p, t, as...) { }
+};
+
+//! \brief A dynamic workload that processes each element at most once
+//! \details Elements are recorded in a visited set sharded by hash, hence appending a duplicate element takes constant
+//! time without a global lock. Elements remain visited across processings, until clear_visited() is called.
+template<class E, class... AS>
+class DedupDynamicWorkload : public DynamicWorkload<E,AS...> {
+  public:
+    using HashFunctionType = std::function<size_t(E const&)>;
+    using typename DynamicWorkload<E,AS...>::TaskFunctionType;
+    using typename DynamicWorkload<E,AS...>::ProgressAcknowledgeFunctionType;
+
+    DedupDynamicWorkload(HashFunctionType h, ProgressAcknowledgeFunctionType p, TaskFunctionType t, AS... as)
+        : DynamicWorkload<E,AS...>(p, t, as...), _visited(SHARDED_SET_DEFAULT_NUM_SHARDS, h) {
+        this->_admission = [this](E const& e) { return _visited.insert(e); };
+    }
+
+    DedupDynamicWorkload(ProgressAcknowledgeFunctionType p, TaskFunctionType t, AS... as)
+        : DedupDynamicWorkload(std::hash<E>(), p, t, as...) { }
+
+    using WorkloadBase<E,AS...>::append;
+    WorkloadInterface<E,AS...>& append(E const& e) override { if (_visited.insert(e)) WorkloadBase<E,AS...>::append(e); return *this; }
+    WorkloadInterface<E,AS...>& append(E&& e) override { if (_visited.insert(e)) WorkloadBase<E,AS...>::append(std::move(e)); return *this; }
+    template<class... ES> WorkloadInterface<E,AS...>& emplace(ES&&... args) { return append(E(std::forward<ES>(args)...)); }
+
+    //! \brief The number of distinct elements appended
+    size_t num_visited() const { return _visited.size(); }
+    //! \brief Forget the elements appended, for them to be processed again if appended
+    void clear_visited() { _visited.clear(); }
+
+  private:
+    ShardedSet<E,HashFunctionType> _visited;
+};
+
 }
 
 #endif // BETTERTHREADS_WORKLOAD_HPP
\ No newline at end of file
@@ -34,13 +34,14 @@
 #define BETTERTHREADS_WORKLOAD_ADVANCEMENT_HPP
 
 #include <algorithm>
-#include <mutex>
+#include <atomic>
 
 namespace BetterThreads {
 
-using std::mutex;
-
 //! \brief Synchronised class to manage the status of multiple elements to process
+//! \details The status is kept as monotonic counts of the appended, started and completed elements, each on its own
+//! cache line and updated without locking. Since completed <= started <= appended at any time, loading the smaller
+//! count first yields a consistent difference between two counts.
 class WorkloadAdvancement {
   public:
     WorkloadAdvancement(size_t initial = 0);
@@ -69,11 +70,9 @@ class WorkloadAdvancement {
     bool has_finished() const;
 
   private:
-    size_t _num_waiting;
-    size_t _num_processing;
-    size_t _num_completed;
-
-    mutex mutable _mux;
+    alignas(64) std::atomic<size_t> _num_appended;
+    alignas(64) std::atomic<size_t> _num_started;
+    alignas(64) std::atomic<size_t> _num_completed;
 };
 
 } // namespace BetterThreads
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *            workload_concurrency_tuner.hpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file workload_concurrency_tuner.hpp
+ *  \brief Hill-climbing of the number of threads processing a workload
+ */
+
+#ifndef BETTERTHREADS_WORKLOAD_CONCURRENCY_TUNER_HPP
+#define BETTERTHREADS_WORKLOAD_CONCURRENCY_TUNER_HPP
+
+#include <cstddef>
+
+namespace BetterThreads {
+
+//! \brief Tunes the number of threads processing a workload, called the level, for the best throughput
+//! \details The throughput is measured at one level at a time. Starting from the best level, the next level is a step
+//! away in the current direction, and it becomes the best level if its throughput is higher by more than a tolerance,
+//! or if it is a lower level with a throughput not lower by more than the tolerance, since threads that do not improve
+//! the throughput are better released. When a direction yields no improvement from the start, the opposite one is tried; when no improvement is available,
+//! the step is halved, until settling on the best level with a unit step. Not synchronised, hence to be used under the
+//! lock of the workload.
+class WorkloadConcurrencyTuner {
+  public:
+    //! \brief The relative improvement of the throughput required to move to a level
+    static constexpr double TOLERANCE = 0.05;
+
+    WorkloadConcurrencyTuner();
+
+    //! \brief Start tuning within levels from 1 to \a maximum
+    //! \details Starts from the best level found previously if any, even if not settled, otherwise from the maximum
+    void start(size_t maximum);
+
+    //! \brief Record the \a throughput measured at the current level, moving to the next level to measure
+    void record(double throughput);
+
+    //! \brief The current level
+    //! \details Zero if tuning has never started
+    size_t level() const;
+    //! \brief The best level found
+    size_t best_level() const;
+    //! \brief Whether the tuning has settled on the best level
+    bool settled() const;
+
+  private:
+    //! \brief Move to the next level to measure from the best one, settling if none remains
+    void _move();
+    //! \brief Change the direction or the step when the current search yields no improvement, returning false if none remains
+    bool _next_search();
+
+  private:
+    size_t _maximum;
+    size_t _level;
+    size_t _best_level;
+    double _best_throughput;
+    size_t _step;
+    int _direction;
+    bool _reversed; // Whether the direction has been reversed since the last change of step
+    bool _improved; // Whether the best level has changed in the current direction
+    bool _settled;
+};
+
+} // namespace BetterThreads
+
+#endif // BETTERTHREADS_WORKLOAD_CONCURRENCY_TUNER_HPP
@@ -44,14 +44,17 @@ using Helper::List;
 //! \brief Interface for a workload expressed as a stack of elements to work on, supplied with a function to process them
 //! \details E: stack element type
 //!          AS: optional input arguments for processing the elements; if used as output, their synchronisation
-//!              in the concurrent case is up to the designer
-//!          The workload handles the non-concurrent case separately, in order to unroll the tasks breadth-first: if
-//!          tasks were instead enqueued to the ThreadManager, a depth-first execution would be performed.
+//!              in the concurrent case is up to the designer, while ReducingWorkload provides per-thread results
+//!          Elements are processed in order from a queue shared by the processing thread and by up to
+//!          ThreadManager::concurrency() threads, hence tasks are unrolled breadth-first unless a different
+//!          scheduling policy is chosen.
 template<class E, class... AS>
 class WorkloadInterface {
 public:
 
     //! \brief Process the given elements until completion
+    //! \details The calling thread takes part in processing the elements. The concurrency of the ThreadManager is the one
+    //! when processing starts, a change taking effect from the next processing.
     virtual void process() = 0;
 
     //! \brief The size of the workload, i.e., the number of tasks to process
@@ -60,6 +63,9 @@ public:
     //! \brief Append one element to process
     virtual WorkloadInterface& append(E const &e) = 0;
 
+    //! \brief Append one element to process, moving it into the workload
+    virtual WorkloadInterface& append(E&& e) = 0;
+
     //! \brief Append a list of elements to process
     virtual WorkloadInterface& append(List<E> const &es) = 0;
 };
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *            workload_statistics.hpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file workload_statistics.hpp
+ *  \brief Statistics on the processing of a workload
+ */
+
+#ifndef BETTERTHREADS_WORKLOAD_STATISTICS_HPP
+#define BETTERTHREADS_WORKLOAD_STATISTICS_HPP
+
+#include <array>
+#include <chrono>
+#include <limits>
+#include <string>
+
+namespace BetterThreads {
+
+//! \brief The ETA value when it cannot be estimated yet
+const std::chrono::nanoseconds WORKLOAD_UNKNOWN_ETA = std::chrono::nanoseconds::max();
+
+//! \brief Statistics on the processing of a workload
+//! \details Element times are measured per chunk and attributed evenly to the elements of the chunk
+struct WorkloadStatistics {
+    size_t num_completed = 0; //!< The elements completed
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds(0); //!< The time since processing started
+    std::chrono::nanoseconds min_element_time = std::chrono::nanoseconds(0); //!< The minimum time of an element
+    std::chrono::nanoseconds mean_element_time = std::chrono::nanoseconds(0); //!< The mean time of an element
+    std::chrono::nanoseconds p95_element_time = std::chrono::nanoseconds(0); //!< The 95th percentile of the time of an element, approximated within 19%
+    std::chrono::nanoseconds max_element_time = std::chrono::nanoseconds(0); //!< The maximum time of an element
+    double throughput = 0.0; //!< The smoothed number of elements completed per second
+    double utilisation = 0.0; //!< The fraction of the time of the processing threads spent on elements
+    std::chrono::nanoseconds eta = WORKLOAD_UNKNOWN_ETA; //!< The estimated time to complete the remaining elements
+};
+
+//! \brief Records the element times of a workload in order to provide its statistics
+//! \details Not synchronised, hence to be used under the lock of the workload
+class WorkloadStatisticsRecorder {
+  public:
+    //! \brief The minimum interval between two throughput samples
+    static constexpr std::chrono::milliseconds SAMPLING_INTERVAL = std::chrono::milliseconds(100);
+
+    WorkloadStatisticsRecorder();
+
+    //! \brief Reset the statistics at the start of processing with up to \a num_threads processing threads
+    void start(size_t num_threads);
+
+    //! \brief Mark the end of processing, after which the statistics do not change
+    void finish();
+
+    //! \brief Record \a num_elements elements completed in \a duration overall, ending at \a end
+    void record(std::chrono::nanoseconds duration, size_t num_elements, std::chrono::steady_clock::time_point end);
+
+    //! \brief The statistics, given the \a num_remaining elements yet to complete
+    WorkloadStatistics statistics(size_t num_remaining) const;
+
+  private:
+    static constexpr size_t BUCKETS_PER_OCTAVE = 4;
+    static constexpr size_t NUM_BUCKETS = 64*BUCKETS_PER_OCTAVE;
+    //! \brief The histogram bucket of an element time of \a ns nanoseconds
+    static size_t _bucket(double ns);
+    //! \brief The upper bound of the times in histogram bucket \a b, in nanoseconds
+    static double _bucket_upper_bound(size_t b);
+
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::time_point _end;
+    bool _finished;
+    size_t _num_threads;
+    size_t _num_completed;
+    double _busy_ns;
+    double _min_ns;
+    double _max_ns;
+    std::array<size_t,NUM_BUCKETS> _histogram;
+
+    std::chrono::steady_clock::time_point _last_sample;
+    size_t _last_sample_completed;
+    double _smoothed_throughput;
+};
+
+//! \brief The throughput and, if known, the ETA of \a statistics, as shown on the progress line of a workload
+std::string progress_summary(WorkloadStatistics const& statistics);
+
+} // namespace BetterThreads
+
+#endif // BETTERTHREADS_WORKLOAD_STATISTICS_HPP
@@ -0,0 +1,260 @@
+/***************************************************************************
+ *            host_resources.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <thread>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <map>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#include "host_resources.hpp"
+
+namespace BetterThreads {
+
+namespace {
+
+//! \brief Read the whole content of the file at \a path, empty if not readable
+String read_file(std::filesystem::path const& path) {
+    std::ifstream file(path);
+    if (not file.is_open()) return String();
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+//! \brief The relative path of the control group of the process for the given \a controller, empty for cgroup v2
+//! \details Returns whether the control group has been found
+bool find_self_cgroup_path(String const& self_cgroup, String const& controller, String& path) {
+    std::istringstream lines(read_file(self_cgroup));
+    String line;
+    while (std::getline(lines, line)) {
+        // Each line has the form hierarchy-ID:controller-list:cgroup-path
+        auto first_colon = line.find(':');
+        auto second_colon = line.find(':', first_colon + 1);
+        if (first_colon == String::npos or second_colon == String::npos) continue;
+        String controllers = "," + line.substr(first_colon + 1, second_colon - first_colon - 1) + ",";
+        if (controllers.find("," + controller + ",") != String::npos) {
+            path = line.substr(second_colon + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+//! \brief The minimum positive value between \a a and \a b, zero if both are zero
+double min_positive(double a, double b) {
+    if (a <= 0) return b;
+    if (b <= 0) return a;
+    return std::min(a, b);
+}
+
+//! \brief The directory of the control group with relative \a path under the \a root, or the \a root itself if not existing
+//! \details Within a container the control group path of the process may not be visible, the root being the control group itself
+std::filesystem::path cgroup_directory(std::filesystem::path const& root, String const& path) {
+    auto const relative = std::filesystem::path(path).relative_path().lexically_normal();
+    if (relative.empty() or relative == "." or *relative.begin() == "..") return root;
+    auto const directory = root / relative;
+    std::error_code error;
+    return (std::filesystem::is_directory(directory, error) ? directory : root);
+}
+
+//! \brief The smallest CPU quota from the \a directory up to the \a root, using \a quota_of for each directory
+template<class F> double smallest_quota_in_hierarchy(std::filesystem::path const& root, std::filesystem::path directory, F const& quota_of) {
+    double result = 0;
+    while (true) {
+        result = min_positive(result, quota_of(directory));
+        if (directory == root or directory.parent_path() == directory) return result;
+        directory = directory.parent_path();
+    }
+}
+
+double cgroup_v2_concurrency(std::filesystem::path const& root, String const& self_cgroup) {
+    String path;
+    find_self_cgroup_path(self_cgroup, "", path);
+    return smallest_quota_in_hierarchy(root, cgroup_directory(root, path), [](std::filesystem::path const& directory) {
+        return cgroup_v2_cpu_quota(read_file(directory / "cpu.max"));
+    });
+}
+
+double cgroup_v1_concurrency(std::filesystem::path const& root, String const& self_cgroup) {
+    String path;
+    find_self_cgroup_path(self_cgroup, "cpu", path);
+    double result = 0;
+    for (auto const& mount : { "cpu", "cpu,cpuacct", "cpuacct,cpu" }) {
+        auto const controller_root = root / mount;
+        std::error_code error;
+        if (not std::filesystem::is_directory(controller_root, error)) continue;
+        result = min_positive(result, smallest_quota_in_hierarchy(controller_root, cgroup_directory(controller_root, path), [](std::filesystem::path const& directory) {
+            long long int quota = -1, period = 0;
+            std::istringstream(read_file(directory / "cpu.cfs_quota_us")) >> quota;
+            std::istringstream(read_file(directory / "cpu.cfs_period_us")) >> period;
+            return cgroup_v1_cpu_quota(quota, period);
+        }));
+    }
+    return result;
+}
+
+} // namespace
+
+size_t hardware_concurrency() {
+    return std::thread::hardware_concurrency();
+}
+
+size_t affinity_concurrency() {
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) return static_cast<size_t>(CPU_COUNT(&cpu_set));
+#endif
+    return hardware_concurrency();
+}
+
+size_t cgroup_concurrency(String const& cgroup_root, String const& self_cgroup) {
+    std::error_code error;
+    auto root = std::filesystem::path(cgroup_root).lexically_normal();
+    if (not root.has_filename() and root.has_parent_path()) root = root.parent_path();
+    if (not std::filesystem::is_directory(root, error)) return 0;
+    double quota = (std::filesystem::exists(root / "cgroup.controllers", error) ? cgroup_v2_concurrency(root, self_cgroup) : cgroup_v1_concurrency(root, self_cgroup));
+    return static_cast<size_t>(std::ceil(quota));
+}
+
+size_t effective_concurrency() {
+    size_t result = 0;
+    for (auto c : { hardware_concurrency(), affinity_concurrency(), cgroup_concurrency() })
+        if (c > 0 and (result == 0 or c < result)) result = c;
+    return result;
+}
+
+CpuTimes cpu_times(String const& proc_stat) {
+    return parse_cpu_times(read_file(proc_stat));
+}
+
+CpuTimes parse_cpu_times(String const& content) {
+    CpuTimes result;
+    std::istringstream ss(content);
+    String label;
+    if (not (ss >> label) or label != "cpu") return result;
+    // The fields are user, nice, system, idle, iowait, irq, softirq, steal, guest, guest_nice,
+    // where guest times are already included in user times
+    unsigned long long int value;
+    for (size_t i=0; i<8 and ss >> value; ++i) {
+        result.total += value;
+        if (i != 3 and i != 4) result.busy += value;
+    }
+    return result;
+}
+
+double cpu_utilisation(CpuTimes const& previous, CpuTimes const& current) {
+    if (current.total <= previous.total or current.busy < previous.busy) return 0;
+    return static_cast<double>(current.busy - previous.busy) / static_cast<double>(current.total - previous.total);
+}
+
+size_t runnable_threads(String const& proc_loadavg) {
+    return parse_runnable_threads(read_file(proc_loadavg));
+}
+
+size_t parse_runnable_threads(String const& content) {
+    // The content has the form load1 load5 load15 runnable/total last_pid
+    std::istringstream ss(content);
+    double load;
+    size_t runnable = 0;
+    if (ss >> load >> load >> load >> runnable) return runnable;
+    return 0;
+}
+
+size_t share_worker_budget(String const& file, size_t budget, size_t demand) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(file.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd < 0) return demand;
+    if (flock(fd, LOCK_EX) != 0) { close(fd); return demand; }
+
+    String content;
+    char buffer[4096];
+    ssize_t num_read;
+    while ((num_read = read(fd, buffer, sizeof(buffer))) > 0) content.append(buffer, static_cast<size_t>(num_read));
+
+    auto const self = static_cast<long long int>(getpid());
+    std::map<long long int,size_t> demands;
+    std::istringstream lines(content);
+    long long int pid;
+    size_t process_demand;
+    while (lines >> pid >> process_demand) {
+        if (pid == self or pid <= 0) continue;
+        if (kill(static_cast<pid_t>(pid), 0) != 0 and errno == ESRCH) continue;
+        demands[pid] = process_demand;
+    }
+    if (demand > 0) demands[self] = demand;
+
+    std::ostringstream ss;
+    size_t total_demand = 0;
+    for (auto const& d : demands) {
+        ss << d.first << " " << d.second << "\n";
+        total_demand += d.second;
+    }
+    auto const updated = ss.str();
+    if (ftruncate(fd, 0) == 0 and lseek(fd, 0, SEEK_SET) == 0) {
+        [[maybe_unused]] auto const written = write(fd, updated.c_str(), updated.size());
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    if (demand == 0 or total_demand <= budget) return demand;
+    return std::max(static_cast<size_t>(1), budget * demand / total_demand);
+#else
+    return demand;
+#endif
+}
+
+double cgroup_v2_cpu_quota(String const& content) {
+    std::istringstream ss(content);
+    String quota;
+    long long int period = 0;
+    if (not (ss >> quota >> period) or quota == "max" or period <= 0) return 0;
+    try {
+        return cgroup_v1_cpu_quota(std::stoll(quota), period);
+    } catch (std::exception&) {
+        return 0;
+    }
+}
+
+double cgroup_v1_cpu_quota(long long int quota_us, long long int period_us) {
+    if (quota_us <= 0 or period_us <= 0) return 0;
+    return static_cast<double>(quota_us) / static_cast<double>(period_us);
+}
+
+} // namespace BetterThreads
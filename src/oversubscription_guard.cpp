@@ -0,0 +1,95 @@
+/***************************************************************************
+ *            oversubscription_guard.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "oversubscription_guard.hpp"
+
+namespace BetterThreads {
+
+OversubscriptionGuard::OversubscriptionGuard(ThreadPool& pool, size_t capacity, std::chrono::milliseconds sampling_interval, String const& budget_file)
+    : _pool(pool), _capacity(std::max(capacity, static_cast<size_t>(1))), _sampling_interval(sampling_interval), _budget_file(budget_file),
+      _allowed_threads(THREAD_POOL_UNLIMITED_ACTIVE_THREADS), _previous_cpu_times(cpu_times()), _stop(false)
+{
+    _sampling_thread = std::thread([this] {
+        while (true) {
+            {
+                unique_lock<mutex> lock(_stop_mutex);
+                if (_stop_condition.wait_for(lock, _sampling_interval, [this] { return _stop; })) return;
+            }
+            update();
+        }
+    });
+}
+
+std::chrono::milliseconds OversubscriptionGuard::sampling_interval() const {
+    return _sampling_interval;
+}
+
+String const& OversubscriptionGuard::budget_file() const {
+    return _budget_file;
+}
+
+size_t OversubscriptionGuard::allowed_threads() const {
+    return _allowed_threads;
+}
+
+void OversubscriptionGuard::update() {
+    lock_guard<mutex> lock(_update_mutex);
+    auto const current_cpu_times = cpu_times();
+    auto const utilisation = cpu_utilisation(_previous_cpu_times, current_cpu_times);
+    _previous_cpu_times = current_cpu_times;
+
+    auto const demand = _pool.num_threads();
+    size_t allowed = THREAD_POOL_UNLIMITED_ACTIVE_THREADS;
+    if (utilisation >= OVERSUBSCRIPTION_GUARD_UTILISATION_THRESHOLD) {
+        // The sampling thread itself is runnable while reading the load
+        auto const own_runnable = _pool.num_busy_threads() + 1;
+        auto const runnable = runnable_threads();
+        auto const competing = (runnable > own_runnable ? runnable - own_runnable : 0);
+        allowed = (_capacity > competing ? _capacity - competing : 1);
+    }
+    if (not _budget_file.empty())
+        allowed = std::min(allowed, std::max(share_worker_budget(_budget_file, _capacity, demand), static_cast<size_t>(1)));
+
+    if (allowed != _allowed_threads) {
+        _allowed_threads = allowed;
+        _pool.set_max_active_threads(allowed);
+    }
+}
+
+OversubscriptionGuard::~OversubscriptionGuard() {
+    {
+        lock_guard<mutex> lock(_stop_mutex);
+        _stop = true;
+    }
+    _stop_condition.notify_all();
+    _sampling_thread.join();
+    if (not _budget_file.empty()) share_worker_budget(_budget_file, _capacity, 0);
+    _pool.set_max_active_threads(THREAD_POOL_UNLIMITED_ACTIVE_THREADS);
+}
+
+} // namespace BetterThreads
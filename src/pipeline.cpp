@@ -0,0 +1,142 @@
+/***************************************************************************
+ *            pipeline.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "helper/macros.hpp"
+#include "thread_pool.hpp"
+#include "pipeline.hpp"
+
+namespace BetterThreads {
+
+PipelineControl::PipelineControl() : _num_in_flight(0), _max_in_flight(PIPELINE_DEFAULT_MAX_IN_FLIGHT), _failed(false), _stop_requested(false) { }
+
+bool PipelineControl::acquire_item() {
+    unique_lock<mutex> lock(_mutex);
+    _item_availability_condition.wait(lock, [this] { return _num_in_flight < _max_in_flight or halted(); });
+    if (halted()) return false;
+    ++_num_in_flight;
+    return true;
+}
+
+void PipelineControl::release_item() {
+    lock_guard<mutex> lock(_mutex);
+    --_num_in_flight;
+    _item_availability_condition.notify_one();
+}
+
+void PipelineControl::fail(exception_ptr e) {
+    lock_guard<mutex> lock(_mutex);
+    if (_exception == nullptr) _exception = e;
+    _failed = true;
+    _item_availability_condition.notify_all();
+}
+
+void PipelineControl::stop() {
+    lock_guard<mutex> lock(_mutex);
+    _stop_requested = true;
+    _item_availability_condition.notify_all();
+}
+
+bool PipelineControl::halted() const {
+    return _failed or _stop_requested;
+}
+
+bool PipelineControl::stop_requested() const {
+    return _stop_requested;
+}
+
+exception_ptr PipelineControl::exception() const {
+    lock_guard<mutex> lock(_mutex);
+    return _exception;
+}
+
+size_t PipelineControl::max_in_flight() const {
+    lock_guard<mutex> lock(_mutex);
+    return _max_in_flight;
+}
+
+void PipelineControl::set_max_in_flight(size_t max) {
+    HELPER_PRECONDITION(max > 0);
+    lock_guard<mutex> lock(_mutex);
+    _max_in_flight = max;
+    _item_availability_condition.notify_all();
+}
+
+Pipeline::Pipeline(shared_ptr<Content> content) : _content(content) { }
+
+void Pipeline::run() {
+    HELPER_ASSERT_MSG(not _content->has_run,"A pipeline can be run only once.");
+    _content->has_run = true;
+    std::vector<std::unique_ptr<ThreadPool>> pools;
+    std::vector<future<void>> workers;
+    for (auto const& stage : _content->stages) {
+        pools.push_back(std::make_unique<ThreadPool>(stage->num_workers(), stage->name()));
+        // The last worker to complete closes the buffer to the next stage, whose workers then complete in turn
+        auto num_active_workers = std::make_shared<std::atomic<size_t>>(stage->num_workers());
+        for (size_t i=0; i<stage->num_workers(); ++i)
+            workers.push_back(pools.back()->enqueue([stage,num_active_workers] {
+                stage->work();
+                if (--*num_active_workers == 0) stage->close_output();
+            }));
+    }
+    for (auto& w : workers) w.get();
+    auto exception = _content->control.exception();
+    if (exception != nullptr) std::rethrow_exception(exception);
+}
+
+void Pipeline::stop() {
+    _content->control.stop();
+}
+
+bool Pipeline::stop_requested() const {
+    return _content->control.stop_requested();
+}
+
+size_t Pipeline::num_stages() const {
+    return _content->stages.size();
+}
+
+size_t Pipeline::buffer_capacity() const {
+    return _content->buffer_capacity;
+}
+
+void Pipeline::set_buffer_capacity(size_t capacity) {
+    HELPER_PRECONDITION(capacity > 0);
+    HELPER_ASSERT_MSG(not _content->has_run,"The buffer capacity must be set before running.");
+    for (auto const& stage : _content->stages) stage->set_buffer_capacity(capacity);
+    _content->buffer_capacity = capacity;
+}
+
+size_t Pipeline::max_in_flight() const {
+    return _content->control.max_in_flight();
+}
+
+void Pipeline::set_max_in_flight(size_t max) {
+    _content->control.set_max_in_flight(max);
+}
+
+} // namespace BetterThreads
@@ -26,6 +26,20 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <memory>
+#include <system_error>
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <climits>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #include "conclog/logging.hpp"
 #include "thread.hpp"
 
@@ -34,12 +48,25 @@ namespace BetterThreads {
 using ConcLog::Logger;
 using Helper::to_string;
 
-Thread::Thread(VoidFunction task, String name, bool active)
-        : _name(std::move(name)), _got_id_future(_got_id_promise.get_future()), _active(active), _ready_for_task_future(_ready_for_task_promise.get_future()),
+#if defined(__unix__) || defined(__APPLE__)
+namespace {
+void* run_native_thread_body(void* body) {
+    std::unique_ptr<VoidFunction> body_ptr(static_cast<VoidFunction*>(body));
+    (*body_ptr)();
+    return nullptr;
+}
+} // namespace
+#endif
+
+Thread::Thread(VoidFunction task, String name, bool active, ThreadAttributes const& attributes)
+        : _name(std::move(name)), _attributes(attributes), _uses_native_thread(false), _native_thread(),
+          _got_id_future(_got_id_promise.get_future()), _active(active), _ready_for_task_future(_ready_for_task_promise.get_future()),
           _exception(nullptr)
 {
-    _thread = std::thread([=,this]() {
+    _start([=,this]() {
         _id = std::this_thread::get_id();
+        if (_name.empty()) _name = to_string(_id);
+        _apply_attributes();
         _got_id_promise.set_value();
         _ready_for_task_future.get();
         if (_active) {
@@ -47,9 +74,8 @@ Thread::Thread(VoidFunction task, String name, bool active)
             catch(...) { _exception = std::current_exception(); }
         }
     });
-    _got_id_future.get();
-    if (_name.empty()) _name = to_string(_id);
     if (active) {
+        _got_id_future.wait();
         Logger::instance().register_thread(_id,_name);
         _ready_for_task_promise.set_value();
     }
@@ -58,16 +84,60 @@ Thread::Thread(VoidFunction task, String name, bool active)
 Thread::Thread(VoidFunction task, String name) : Thread(task, name, true)
 { }
 
+void Thread::_start(VoidFunction body) {
+#if defined(__unix__) || defined(__APPLE__)
+    if (_attributes.stack_size > 0) {
+        // Some platforms require the stack size to be a multiple of the page size
+        auto const page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        auto const stack_size = (std::max(_attributes.stack_size, static_cast<size_t>(PTHREAD_STACK_MIN)) + page_size - 1)/page_size*page_size;
+        pthread_attr_t native_attributes;
+        pthread_attr_init(&native_attributes);
+        int const stack_result = pthread_attr_setstacksize(&native_attributes, stack_size);
+        if (stack_result != 0) {
+            pthread_attr_destroy(&native_attributes);
+            throw std::system_error(stack_result, std::generic_category(), "Setting the thread stack size to " + to_string(stack_size) + " failed");
+        }
+        auto body_ptr = new VoidFunction(std::move(body));
+        int result = pthread_create(&_native_thread, &native_attributes, &run_native_thread_body, body_ptr);
+        pthread_attr_destroy(&native_attributes);
+        if (result != 0) {
+            delete body_ptr;
+            throw std::system_error(result, std::generic_category(), "Thread creation with custom stack size failed");
+        }
+        _uses_native_thread = true;
+        return;
+    }
+#endif
+    _thread = std::thread(std::move(body));
+}
+
+void Thread::_apply_attributes() const {
+#if defined(__linux__)
+    if (_attributes.set_os_name) pthread_setname_np(pthread_self(), _name.substr(0,15).c_str());
+    if (_attributes.scheduling_class != ThreadSchedulingClass::DEFAULT) {
+        sched_param parameters{};
+        parameters.sched_priority = 0;
+        pthread_setschedparam(pthread_self(), (_attributes.scheduling_class == ThreadSchedulingClass::BATCH ? SCHED_BATCH : SCHED_IDLE), &parameters);
+    }
+    if (_attributes.nice != 0) setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), _attributes.nice);
+#elif defined(__APPLE__)
+    if (_attributes.set_os_name) pthread_setname_np(_name.substr(0,63).c_str());
+#endif
+}
+
 thread::id Thread::id() const {
+    _got_id_future.wait();
     return _id;
 }
 
 String Thread::name() const {
+    _got_id_future.wait();
     return _name;
 }
 
 void Thread::activate()  {
     if (not _active) {
+        _got_id_future.wait();
         _active = true;
         Logger::instance().register_thread(_id,_name);
         _ready_for_task_promise.set_value();
@@ -78,11 +148,17 @@ exception_ptr const& Thread::exception() const {
     return _exception;
 }
 
+ThreadAttributes const& Thread::attributes() const {
+    return _attributes;
+}
+
 Thread::~Thread() {
     if (not _active) _ready_for_task_promise.set_value();
     else Logger::instance().unregister_thread(_id);
+#if defined(__unix__) || defined(__APPLE__)
+    if (_uses_native_thread) { pthread_join(_native_thread, nullptr); return; }
+#endif
     _thread.join();
-
 }
 
 } // namespace BetterThreads
@@ -28,50 +28,158 @@
 
 #include "helper/macros.hpp"
 #include "conclog/logging.hpp"
+#include "host_resources.hpp"
 #include "thread_manager.hpp"
 
 namespace BetterThreads {
 
 using ConcLog::Logger;
 
-ThreadManager::ThreadManager() : _maximum_concurrency(std::thread::hardware_concurrency()), _concurrency(0), _pool(0) {}
+ThreadManager::ThreadManager() : _hardware_concurrency(BetterThreads::hardware_concurrency()), _maximum_concurrency(effective_concurrency()), _concurrency(0), _total_concurrency(0), _pool(0) {}
 
 bool ThreadManager::has_threads_registered() const {
-    return _concurrency;
+    return _total_concurrency > 0;
 }
 
 size_t ThreadManager::maximum_concurrency() const {
     return _maximum_concurrency;
 }
 
+size_t ThreadManager::hardware_concurrency() const {
+    return _hardware_concurrency;
+}
+
 size_t ThreadManager::concurrency() const {
     lock_guard<mutex> lock(_concurrency_mutex);
     return _concurrency;
 }
 
+size_t ThreadManager::total_concurrency() const {
+    return _total_concurrency;
+}
+
 void ThreadManager::set_concurrency(size_t value) {
     HELPER_PRECONDITION(value <= _maximum_concurrency);
-    lock_guard<mutex> lock(_concurrency_mutex);
-    _concurrency = value;
+    // The lock on the concurrency is released before resizing, since workers may need it before parking
+    lock_guard<mutex> resizing_lock(_resizing_mutex);
+    {
+        lock_guard<mutex> lock(_concurrency_mutex);
+        _total_concurrency = _check_total_concurrency(_pool.name(), value);
+        _concurrency = value;
+    }
     _pool.set_num_threads(value);
 }
 
+void ThreadManager::add_pool(String const& name, size_t concurrency, ThreadAttributes const& attributes) {
+    lock_guard<mutex> resizing_lock(_resizing_mutex);
+    lock_guard<mutex> lock(_concurrency_mutex);
+    HELPER_ASSERT_MSG(name != _pool.name() and not _named_pools.contains(name),"A pool named '" << name << "' already exists.");
+    _total_concurrency = _check_total_concurrency(name, concurrency);
+    _named_pools.emplace(name, make_shared<ThreadPool>(concurrency, name, false, attributes));
+}
+
+bool ThreadManager::has_pool(String const& name) const {
+    lock_guard<mutex> lock(_concurrency_mutex);
+    return name == _pool.name() or _named_pools.contains(name);
+}
+
+size_t ThreadManager::pool_concurrency(String const& name) const {
+    if (name == _pool.name()) return concurrency();
+    lock_guard<mutex> lock(_concurrency_mutex);
+    return _pool_at(name)->num_threads();
+}
+
+void ThreadManager::set_pool_concurrency(String const& name, size_t value) {
+    if (name == _pool.name()) { set_concurrency(value); return; }
+    lock_guard<mutex> resizing_lock(_resizing_mutex);
+    shared_ptr<ThreadPool> pool;
+    {
+        lock_guard<mutex> lock(_concurrency_mutex);
+        _total_concurrency = _check_total_concurrency(name, value);
+        pool = _pool_at(name);
+    }
+    pool->set_num_threads(value);
+}
+
+shared_ptr<ThreadPool> const& ThreadManager::_pool_at(String const& name) const {
+    auto p = _named_pools.find(name);
+    HELPER_ASSERT_MSG(p != _named_pools.end(),"No pool named '" << name << "' exists.");
+    return p->second;
+}
+
+size_t ThreadManager::_check_total_concurrency(String const& name, size_t value) const {
+    size_t total = value + (name == _pool.name() ? 0 : _concurrency);
+    for (auto const& p : _named_pools) if (p.first != name) total += p.second->num_threads();
+    HELPER_PRECONDITION(total <= _maximum_concurrency);
+    return total;
+}
+
 void ThreadManager::set_maximum_concurrency() {
-    set_concurrency(_maximum_concurrency);
+    lock_guard<mutex> resizing_lock(_resizing_mutex);
+    size_t value = 0;
+    {
+        lock_guard<mutex> lock(_concurrency_mutex);
+        size_t named_concurrency = 0;
+        for (auto const& p : _named_pools) named_concurrency += p.second->num_threads();
+        value = (_maximum_concurrency > named_concurrency ? _maximum_concurrency - named_concurrency : 0);
+        _concurrency = value;
+        _total_concurrency = value + named_concurrency;
+    }
+    _pool.set_num_threads(value);
+}
+
+void ThreadManager::enable_adaptive_concurrency(std::chrono::milliseconds sampling_interval, String const& budget_file) {
+    lock_guard<mutex> lock(_oversubscription_guard_mutex);
+    _oversubscription_guard.reset();
+    _oversubscription_guard = std::make_unique<OversubscriptionGuard>(_pool, _maximum_concurrency, sampling_interval, budget_file);
+}
+
+void ThreadManager::disable_adaptive_concurrency() {
+    lock_guard<mutex> lock(_oversubscription_guard_mutex);
+    _oversubscription_guard.reset();
+}
+
+bool ThreadManager::has_adaptive_concurrency() const {
+    lock_guard<mutex> lock(_oversubscription_guard_mutex);
+    return _oversubscription_guard != nullptr;
+}
+
+size_t ThreadManager::active_concurrency() const {
+    return std::min(concurrency(), _pool.max_active_threads());
+}
+
+void ThreadManager::set_caller_runs_threshold(size_t threshold) {
+    _pool.set_caller_runs_threshold(threshold);
+}
+
+bool ThreadManager::run_pending_task() {
+    return _pool.run_pending_task();
+}
+
+void ThreadManager::set_lazy_thread_activation(bool lazy) {
+    _pool.set_lazy_activation(lazy);
+}
+
+void ThreadManager::set_thread_attributes(ThreadAttributes const& attributes) {
+    _pool.set_thread_attributes(attributes);
+}
+
+void ThreadManager::set_thread_parking_timeout(std::chrono::milliseconds timeout) {
+    _pool.set_parking_timeout(timeout);
 }
 
 void ThreadManager::set_logging_immediate_scheduler() const {
-    HELPER_PRECONDITION(_concurrency == 0)
+    HELPER_PRECONDITION(not has_threads_registered())
     Logger::instance().use_immediate_scheduler();
 }
 
 void ThreadManager::set_logging_blocking_scheduler() const {
-    HELPER_PRECONDITION(_concurrency == 0)
+    HELPER_PRECONDITION(not has_threads_registered())
     Logger::instance().use_blocking_scheduler();
 }
 
 void ThreadManager::set_logging_nonblocking_scheduler() const {
-    HELPER_PRECONDITION(_concurrency == 0)
+    HELPER_PRECONDITION(not has_threads_registered())
     Logger::instance().use_nonblocking_scheduler();
 }
 
@@ -26,6 +26,7 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "helper/macros.hpp"
 #include "thread_pool.hpp"
 
 namespace BetterThreads {
@@ -40,41 +41,126 @@ String construct_thread_name(String prefix, size_t number, size_t max_number) {
 
 VoidFunction ThreadPool::_task_wrapper_function(size_t i) {
     return [i, this] {
+        bool executed_task = false;
         while (true) {
             VoidFunction task;
-            bool got_task = false;
+            bool bounded_queue = false;
             {
                 unique_lock<mutex> lock(_task_availability_mutex);
+                if (executed_task) { ++_num_idle_threads; --_num_busy_threads; executed_task = false; }
                 _task_availability_condition.wait(lock, [=, this] {
-                    return _finish_all_and_stop or (_num_active_threads > _num_threads_to_use) or not _tasks.empty();
+                    return _finish_all_and_stop or (i >= _num_usable_threads()) or not _tasks.empty();
                 });
-                if (_finish_all_and_stop and _tasks.empty()) return;
-                if (not _tasks.empty()) {
-                    task = std::move(_tasks.front());
-                    _tasks.pop();
-                    got_task = true;
+                if (i >= _num_usable_threads() and not _finish_all_and_stop) {
+                    if (_park(i, lock)) continue;
+                    else return;
                 }
+                if (_finish_all_and_stop and _tasks.empty()) { --_num_idle_threads; return; }
+                task = std::move(_tasks.front());
+                _tasks.pop();
+                --_num_idle_threads;
+                ++_num_busy_threads;
+                executed_task = true;
+                bounded_queue = (_queue_capacity != THREAD_POOL_UNBOUNDED_QUEUE_CAPACITY);
             }
-            if (got_task) task();
-            if (i>=_num_threads_to_use) {
-                lock_guard<mutex> active_threads_lock(_num_active_threads_mutex);
-                _num_active_threads--;
-                if (_num_active_threads == _num_threads_to_use) _all_unused_threads_stopped_promise.set_value();
-                return;
-            }
+            if (bounded_queue) _task_space_condition.notify_one();
+            task();
         }
     };
 }
 
+bool ThreadPool::_park(size_t i, unique_lock<mutex>& lock) {
+    --_num_idle_threads;
+    ++_num_parked_threads;
+    _parking_completion_condition.notify_all();
+    auto const retirement_time = std::chrono::steady_clock::now() + _parking_timeout;
+    bool timed_out = false;
+    while (true) {
+        if (_finish_all_and_stop) {
+            --_num_parked_threads;
+            return false;
+        }
+        if (i < _num_usable_threads()) {
+            --_num_parked_threads;
+            ++_num_idle_threads;
+            return true;
+        }
+        // Only the last live thread can retire, in order for the live threads to be a prefix of the thread list;
+        // threads parked due to the maximum number of active threads are not retired since they are still to be used
+        if (timed_out and i+1 == _num_live_threads and i >= _num_threads_to_use) {
+            --_num_parked_threads;
+            --_num_live_threads;
+            _revival_condition.notify_all();
+            return false;
+        }
+        if (timed_out) _revival_condition.wait(lock);
+        else timed_out = (_revival_condition.wait_until(lock, retirement_time) == std::cv_status::timeout);
+    }
+}
+
 void ThreadPool::_append_thread_range(size_t lower, size_t upper) {
     for (size_t i=lower; i<upper; ++i) {
-        _threads.push_back(make_shared<Thread>(ThreadPool::_task_wrapper_function(i), construct_thread_name(_name,i,upper)));
+        _threads.push_back(make_shared<Thread>(ThreadPool::_task_wrapper_function(i), construct_thread_name(_name,i,upper), false, _thread_attributes));
+    }
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        _num_live_threads = upper;
+    }
+    if (not _lazy_activation) {
+        while (_num_activated_threads < upper)
+            _activate_next_thread();
+    }
+}
+
+void ThreadPool::_activate_next_thread() {
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        ++_num_idle_threads;
+    }
+    _threads.at(_num_activated_threads++)->activate();
+}
+
+void ThreadPool::_activate_threads_on_demand() {
+    size_t num_missing, num_usable;
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        num_missing = (_tasks.size() > _num_idle_threads ? _tasks.size() - _num_idle_threads : 0);
+        num_usable = std::min(_num_usable_threads(), _threads.size());
+    }
+    for (size_t i=0; i<num_missing and _num_activated_threads < num_usable; ++i)
+        _activate_next_thread();
+}
+
+void ThreadPool::_try_activate_threads_on_demand() {
+    _activation_pending = true;
+    unique_lock<mutex> lock(_num_threads_mutex, std::try_to_lock);
+    // The holder of the lock checks the pending activation after releasing it
+    if (not lock.owns_lock()) return;
+    _activation_pending = false;
+    _activate_threads_on_demand();
+    _unlock_num_threads(lock);
+}
+
+void ThreadPool::_unlock_num_threads(unique_lock<mutex>& lock) {
+    lock.unlock();
+    if (_activation_pending) _try_activate_threads_on_demand();
+}
+
+void ThreadPool::_remove_threads_from(size_t number) {
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        _num_live_threads = std::min(_num_live_threads, number);
     }
+    _threads.resize(number);
+    _num_activated_threads = std::min(_num_activated_threads.load(), number);
 }
 
-ThreadPool::ThreadPool(size_t size, String name)
-        : _name(name), _finish_all_and_stop(false), _num_active_threads(size), _num_threads_to_use(size),
-          _all_unused_threads_stopped_future(_all_unused_threads_stopped_promise.get_future())
+ThreadPool::ThreadPool(size_t size, String name, bool lazy_activation, ThreadAttributes const& attributes)
+        : _name(name), _queue_capacity(THREAD_POOL_UNBOUNDED_QUEUE_CAPACITY), _queue_full_policy(QueueFullPolicy::BLOCK),
+          _caller_runs_threshold(THREAD_POOL_CALLER_RUNS_DISABLED), _lazy_activation(lazy_activation),
+          _parking_timeout(THREAD_POOL_DEFAULT_PARKING_TIMEOUT), _thread_attributes(attributes), _finish_all_and_stop(false), _num_idle_threads(0), _num_busy_threads(0),
+          _num_parked_threads(0), _num_live_threads(0), _num_activated_threads(0), _num_threads_to_use(size), _max_active_threads(THREAD_POOL_UNLIMITED_ACTIVE_THREADS),
+          _activation_pending(false)
 {
     _append_thread_range(0,size);
 }
@@ -84,24 +170,107 @@ String ThreadPool::name() const {
 }
 
 size_t ThreadPool::num_threads() const {
-    lock_guard<mutex> lock(_num_threads_mutex);
-    return _threads.size();
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _num_threads_to_use;
+}
+
+size_t ThreadPool::num_activated_threads() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return std::min(_num_activated_threads.load(), _num_threads_to_use);
+}
+
+size_t ThreadPool::num_busy_threads() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _num_busy_threads;
+}
+
+size_t ThreadPool::num_parked_threads() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _num_parked_threads;
 }
 
 void ThreadPool::set_num_threads(size_t number) {
-    lock_guard<mutex> lock(_num_threads_mutex);
-    auto old_size = _threads.size();
+    unique_lock<mutex> lock(_num_threads_mutex);
+    unique_lock<mutex> task_availability_lock(_task_availability_mutex);
+    auto const live_threads = _num_live_threads;
+    task_availability_lock.unlock();
+    // Reap the retired threads, whose Thread objects are still held
+    if (_threads.size() > live_threads) _remove_threads_from(live_threads);
+
+    task_availability_lock.lock();
+    auto const old_number = _num_threads_to_use;
     _num_threads_to_use = number;
-    if (number > old_size) {
-        _num_active_threads = number;
-        _append_thread_range(old_size,number);
-    } else if (number < old_size) {
+    if (number > old_number) {
+        task_availability_lock.unlock();
+        _revival_condition.notify_all();
+        if (number > _threads.size()) _append_thread_range(_threads.size(),number);
+        if (_lazy_activation) _activate_threads_on_demand();
+    } else if (number < old_number) {
         _task_availability_condition.notify_all();
-        _all_unused_threads_stopped_future.get();
-        _threads.resize(number);
-        _all_unused_threads_stopped_promise = promise<void>();
-        _all_unused_threads_stopped_future = _all_unused_threads_stopped_promise.get_future();
+        _parking_completion_condition.wait(task_availability_lock, [number, this] {
+            auto const activated = std::min(_num_activated_threads.load(), _num_live_threads);
+            return _num_parked_threads + std::min(number, _max_active_threads) >= activated;
+        });
+        task_availability_lock.unlock();
+        // Threads never activated are not worth parking
+        if (_threads.size() > std::max(number, _num_activated_threads.load())) _remove_threads_from(std::max(number, _num_activated_threads.load()));
+    }
+    _unlock_num_threads(lock);
+}
+
+size_t ThreadPool::max_active_threads() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _max_active_threads;
+}
+
+void ThreadPool::set_max_active_threads(size_t number) {
+    HELPER_PRECONDITION(number > 0);
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        _max_active_threads = number;
     }
+    _task_availability_condition.notify_all();
+    _revival_condition.notify_all();
+    if (_lazy_activation) _try_activate_threads_on_demand();
+}
+
+std::chrono::milliseconds ThreadPool::parking_timeout() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _parking_timeout;
+}
+
+void ThreadPool::set_parking_timeout(std::chrono::milliseconds timeout) {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    _parking_timeout = timeout;
+}
+
+ThreadAttributes ThreadPool::thread_attributes() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _thread_attributes;
+}
+
+void ThreadPool::set_thread_attributes(ThreadAttributes const& attributes) {
+    unique_lock<mutex> lock(_num_threads_mutex);
+    {
+        // Written under both locks, for the getter not to take the lock on the number of threads
+        lock_guard<mutex> task_availability_lock(_task_availability_mutex);
+        _thread_attributes = attributes;
+    }
+    _unlock_num_threads(lock);
+}
+
+bool ThreadPool::lazy_activation() const {
+    return _lazy_activation;
+}
+
+void ThreadPool::set_lazy_activation(bool lazy) {
+    unique_lock<mutex> lock(_num_threads_mutex);
+    _lazy_activation = lazy;
+    if (not lazy) {
+        while (_num_activated_threads < _threads.size())
+            _activate_next_thread();
+    }
+    _unlock_num_threads(lock);
 }
 
 size_t ThreadPool::queue_size() const {
@@ -109,12 +278,97 @@ size_t ThreadPool::queue_size() const {
     return _tasks.size();
 }
 
+bool ThreadPool::run_pending_task() {
+    VoidFunction task;
+    bool bounded_queue = false;
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        if (_tasks.empty()) return false;
+        task = std::move(_tasks.front());
+        _tasks.pop();
+        bounded_queue = (_queue_capacity != THREAD_POOL_UNBOUNDED_QUEUE_CAPACITY);
+    }
+    if (bounded_queue) _task_space_condition.notify_one();
+    task();
+    return true;
+}
+
+size_t ThreadPool::queue_capacity() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _queue_capacity;
+}
+
+void ThreadPool::set_queue_capacity(size_t capacity) {
+    HELPER_PRECONDITION(capacity > 0);
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        HELPER_ASSERT_MSG(capacity >= _tasks.size(),"Reducing capacity below current queue size is not allowed.");
+        _queue_capacity = capacity;
+    }
+    _task_space_condition.notify_all();
+}
+
+QueueFullPolicy ThreadPool::queue_full_policy() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _queue_full_policy;
+}
+
+void ThreadPool::set_queue_full_policy(QueueFullPolicy policy) {
+    {
+        lock_guard<mutex> lock(_task_availability_mutex);
+        _queue_full_policy = policy;
+    }
+    _task_space_condition.notify_all();
+}
+
+size_t ThreadPool::caller_runs_threshold() const {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    return _caller_runs_threshold;
+}
+
+void ThreadPool::set_caller_runs_threshold(size_t threshold) {
+    lock_guard<mutex> lock(_task_availability_mutex);
+    _caller_runs_threshold = threshold;
+}
+
+bool ThreadPool::_apply_caller_runs_policy(unique_lock<mutex>& lock) {
+    if (_tasks.size() >= _caller_runs_threshold and _num_busy_threads >= _num_usable_threads()) {
+        lock.unlock();
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::_apply_queue_full_policy(unique_lock<mutex>& lock) {
+    while (_tasks.size() >= _queue_capacity) {
+        switch (_queue_full_policy) {
+            case QueueFullPolicy::BLOCK:
+                _task_space_condition.wait(lock);
+                if (_finish_all_and_stop) throw StoppedThreadPoolException();
+                break;
+            case QueueFullPolicy::FAIL:
+                throw FullThreadPoolQueueException();
+            case QueueFullPolicy::CALLER_RUNS:
+                lock.unlock();
+                return true;
+            case QueueFullPolicy::DROP_OLDEST:
+                _tasks.pop();
+                break;
+            default:
+                HELPER_FAIL_MSG("Unhandled queue full policy");
+        }
+    }
+    return false;
+}
+
 ThreadPool::~ThreadPool() {
     {
         lock_guard<mutex> task_availability_lock(_task_availability_mutex);
         _finish_all_and_stop = true;
     }
     _task_availability_condition.notify_all();
+    _task_space_condition.notify_all();
+    _revival_condition.notify_all();
     _threads.clear();
 }
 
@@ -31,59 +31,53 @@
 
 namespace BetterThreads {
 
-using std::lock_guard;
-
-WorkloadAdvancement::WorkloadAdvancement(size_t initial) : _num_waiting(initial), _num_processing(0), _num_completed(0) { }
+WorkloadAdvancement::WorkloadAdvancement(size_t initial) : _num_appended(initial), _num_started(0), _num_completed(0) { }
 
 size_t WorkloadAdvancement::waiting() const {
-    lock_guard<mutex> lock(_mux);
-    return _num_waiting;
+    auto const started = _num_started.load();
+    return _num_appended.load() - started;
 }
 
 size_t WorkloadAdvancement::processing() const {
-    lock_guard<mutex> lock(_mux);
-    return _num_processing;
+    auto const completed = _num_completed.load();
+    return _num_started.load() - completed;
 }
 
 size_t WorkloadAdvancement::completed() const {
-    lock_guard<mutex> lock(_mux);
-    return _num_completed;
+    return _num_completed.load();
 }
 
 size_t WorkloadAdvancement::total() const {
-    lock_guard<mutex> lock(_mux);
-    return _num_waiting + _num_processing + _num_completed;
+    return _num_appended.load();
 }
 
 void WorkloadAdvancement::add_to_waiting(size_t n) {
     HELPER_PRECONDITION(n > 0);
-    lock_guard<mutex> lock(_mux);
-    _num_waiting+=n;
+    _num_appended.fetch_add(n);
 }
 
 void WorkloadAdvancement::add_to_processing(size_t n) {
-    HELPER_PRECONDITION(n <= _num_waiting);
-    lock_guard<mutex> lock(_mux);
-    _num_waiting-=n;
-    _num_processing+=n;
+    auto started = _num_started.load();
+    do {
+        HELPER_PRECONDITION(started + n <= _num_appended.load());
+    } while (not _num_started.compare_exchange_weak(started, started + n));
 }
 
 void WorkloadAdvancement::add_to_completed(size_t n) {
-    HELPER_PRECONDITION(n <=_num_processing);
-    lock_guard<mutex> lock(_mux);
-    _num_processing-=n;
-    _num_completed+=n;
+    auto completed = _num_completed.load();
+    do {
+        HELPER_PRECONDITION(completed + n <= _num_started.load());
+    } while (not _num_completed.compare_exchange_weak(completed, completed + n));
 }
 
 double WorkloadAdvancement::completion_rate() const {
-    lock_guard<mutex> lock(_mux);
-    auto total = static_cast<double>(_num_waiting + _num_processing + _num_completed);
-    return static_cast<double>(_num_completed) / total;
+    auto const completed = static_cast<double>(_num_completed.load());
+    return completed / static_cast<double>(_num_appended.load());
 }
 
 bool WorkloadAdvancement::has_finished() const {
-    lock_guard<mutex> lock(_mux);
-    return _num_processing == 0 and _num_waiting == 0;
+    auto const completed = _num_completed.load();
+    return completed == _num_appended.load();
 }
 
 } // namespace BetterThreads
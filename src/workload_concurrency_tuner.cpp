@@ -0,0 +1,111 @@
+/***************************************************************************
+ *            workload_concurrency_tuner.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include "helper/macros.hpp"
+#include "workload_concurrency_tuner.hpp"
+
+namespace BetterThreads {
+
+WorkloadConcurrencyTuner::WorkloadConcurrencyTuner()
+    : _maximum(0), _level(0), _best_level(0), _best_throughput(0.0), _step(1), _direction(-1), _reversed(false), _improved(false), _settled(false) { }
+
+void WorkloadConcurrencyTuner::start(size_t maximum) {
+    HELPER_PRECONDITION(maximum > 0);
+    _maximum = maximum;
+    _level = (_best_level > 0 ? std::min(_best_level, maximum) : maximum);
+    _best_level = _level;
+    _best_throughput = 0.0;
+    _step = std::max<size_t>(1, maximum/4);
+    _direction = -1;
+    _reversed = false;
+    _improved = false;
+    _settled = (maximum == 1);
+}
+
+void WorkloadConcurrencyTuner::record(double throughput) {
+    if (_settled) return;
+    if (_level == _best_level) {
+        _best_throughput = throughput;
+    } else if (throughput > _best_throughput*(1.0+TOLERANCE) or (_level < _best_level and throughput >= _best_throughput*(1.0-TOLERANCE))) {
+        // Keeping the highest throughput, otherwise successive lower levels could each lose up to the tolerance
+        _best_level = _level;
+        _best_throughput = std::max(_best_throughput, throughput);
+        _improved = true;
+    } else if (not _next_search()) {
+        _level = _best_level;
+        _settled = true;
+        return;
+    }
+    _move();
+}
+
+size_t WorkloadConcurrencyTuner::level() const {
+    return _level;
+}
+
+size_t WorkloadConcurrencyTuner::best_level() const {
+    return _best_level;
+}
+
+bool WorkloadConcurrencyTuner::settled() const {
+    return _settled;
+}
+
+void WorkloadConcurrencyTuner::_move() {
+    while (true) {
+        auto const step = static_cast<long>(_step);
+        auto const candidate = static_cast<long>(_best_level) + (_direction > 0 ? step : -step);
+        if (candidate >= 1 and candidate <= static_cast<long>(_maximum)) {
+            _level = static_cast<size_t>(candidate);
+            return;
+        }
+        if (not _next_search()) {
+            _level = _best_level;
+            _settled = true;
+            return;
+        }
+    }
+}
+
+bool WorkloadConcurrencyTuner::_next_search() {
+    if (not _improved and not _reversed) {
+        _direction = -_direction;
+        _reversed = true;
+        return true;
+    }
+    if (_step > 1) {
+        _step /= 2;
+        _reversed = false;
+        _improved = false;
+        return true;
+    }
+    return false;
+}
+
+} // namespace BetterThreads
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *            workload_statistics.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include "helper/macros.hpp"
+#include "workload_statistics.hpp"
+
+namespace BetterThreads {
+
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+WorkloadStatisticsRecorder::WorkloadStatisticsRecorder() {
+    start(1);
+}
+
+void WorkloadStatisticsRecorder::start(size_t num_threads) {
+    HELPER_PRECONDITION(num_threads > 0);
+    _start = steady_clock::now();
+    _finished = false;
+    _num_threads = num_threads;
+    _num_completed = 0;
+    _busy_ns = 0.0;
+    _min_ns = std::numeric_limits<double>::max();
+    _max_ns = 0.0;
+    _histogram.fill(0);
+    _last_sample = _start;
+    _last_sample_completed = 0;
+    _smoothed_throughput = 0.0;
+}
+
+void WorkloadStatisticsRecorder::finish() {
+    _end = steady_clock::now();
+    _finished = true;
+}
+
+size_t WorkloadStatisticsRecorder::_bucket(double ns) {
+    if (ns <= 1.0) return 0;
+    return std::min(NUM_BUCKETS-1, static_cast<size_t>(std::log2(ns)*static_cast<double>(BUCKETS_PER_OCTAVE)));
+}
+
+double WorkloadStatisticsRecorder::_bucket_upper_bound(size_t b) {
+    return std::exp2(static_cast<double>(b+1)/static_cast<double>(BUCKETS_PER_OCTAVE));
+}
+
+void WorkloadStatisticsRecorder::record(nanoseconds duration, size_t num_elements, steady_clock::time_point end) {
+    if (num_elements == 0) return;
+    auto const duration_ns = static_cast<double>(duration.count());
+    auto const element_ns = duration_ns/static_cast<double>(num_elements);
+    _num_completed += num_elements;
+    _busy_ns += duration_ns;
+    _min_ns = std::min(_min_ns, element_ns);
+    _max_ns = std::max(_max_ns, element_ns);
+    _histogram[_bucket(element_ns)] += num_elements;
+
+    auto const sample_interval = std::chrono::duration<double>(end - _last_sample).count();
+    if (end - _last_sample >= SAMPLING_INTERVAL) {
+        double const throughput = static_cast<double>(_num_completed - _last_sample_completed)/sample_interval;
+        _smoothed_throughput = (_smoothed_throughput == 0.0 ? throughput : 0.7*_smoothed_throughput + 0.3*throughput);
+        _last_sample = end;
+        _last_sample_completed = _num_completed;
+    }
+}
+
+WorkloadStatistics WorkloadStatisticsRecorder::statistics(size_t num_remaining) const {
+    WorkloadStatistics result;
+    result.num_completed = _num_completed;
+    result.elapsed = (_finished ? _end : steady_clock::now()) - _start;
+    auto const elapsed_s = std::chrono::duration<double>(result.elapsed).count();
+    if (_num_completed > 0) {
+        result.min_element_time = nanoseconds(static_cast<nanoseconds::rep>(_min_ns));
+        result.max_element_time = nanoseconds(static_cast<nanoseconds::rep>(_max_ns));
+        result.mean_element_time = nanoseconds(static_cast<nanoseconds::rep>(_busy_ns/static_cast<double>(_num_completed)));
+        auto const p95_rank = static_cast<size_t>(std::ceil(0.95*static_cast<double>(_num_completed)));
+        size_t cumulative = 0;
+        for (size_t b=0; b<NUM_BUCKETS; ++b) {
+            cumulative += _histogram[b];
+            if (cumulative >= p95_rank) {
+                auto const p95_ns = std::clamp(_bucket_upper_bound(b), _min_ns, _max_ns);
+                result.p95_element_time = nanoseconds(static_cast<nanoseconds::rep>(p95_ns));
+                break;
+            }
+        }
+    }
+    result.throughput = (_smoothed_throughput > 0.0 ? _smoothed_throughput :
+                         (elapsed_s > 0.0 ? static_cast<double>(_num_completed)/elapsed_s : 0.0));
+    if (elapsed_s > 0.0)
+        result.utilisation = std::min(1.0, _busy_ns/(elapsed_s*1e9*static_cast<double>(_num_threads)));
+    if (num_remaining == 0) result.eta = nanoseconds(0);
+    else if (result.throughput > 0.0)
+        result.eta = nanoseconds(static_cast<nanoseconds::rep>(static_cast<double>(num_remaining)/result.throughput*1e9));
+    return result;
+}
+
+std::string progress_summary(WorkloadStatistics const& statistics) {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1) << statistics.throughput << "/s";
+    if (statistics.eta != WORKLOAD_UNKNOWN_ETA)
+        stream << " eta=" << std::chrono::duration_cast<std::chrono::seconds>(statistics.eta).count() << "s";
+    return stream.str();
+}
+
+} // namespace BetterThreads
@@ -27,6 +27,8 @@
  */
 
 #include <thread>
+#include <vector>
+#include <atomic>
 #include "helper/test.hpp"
 #include "buffer.hpp"
 
@@ -105,6 +107,31 @@ class TestBuffer {
         thread.join();
     }
 
+    void test_close_with_multiple_consumers() {
+        Buffer<size_t> buffer(4);
+        std::atomic<size_t> sum = 0, num_finished = 0;
+        std::vector<std::thread> consumers;
+        for (size_t i=0; i<3; ++i)
+            consumers.emplace_back([&buffer,&sum,&num_finished]() {
+                while (true) {
+                    try {
+                        sum += buffer.pull();
+                    } catch (BufferInterruptPullingException&) {
+                        ++num_finished;
+                        break;
+                    }
+                }
+            });
+        for (size_t i=1; i<=10; ++i) buffer.push(i);
+        HELPER_TEST_ASSERT(not buffer.is_closed());
+        buffer.close();
+        HELPER_TEST_ASSERT(buffer.is_closed());
+        for (auto& c : consumers) c.join();
+        HELPER_TEST_EQUALS(num_finished,3);
+        HELPER_TEST_EQUALS(sum,55);
+        HELPER_TEST_FAIL(buffer.pull());
+    }
+
     void test() {
         HELPER_TEST_CALL(test_construct());
         HELPER_TEST_CALL(test_construct_invalid());
@@ -112,6 +139,7 @@ class TestBuffer {
         HELPER_TEST_CALL(test_set_capacity_when_filled());
         HELPER_TEST_CALL(test_single_buffer());
         HELPER_TEST_CALL(test_io_buffer());
+        HELPER_TEST_CALL(test_close_with_multiple_consumers());
     }
 };
 
@@ -0,0 +1,145 @@
+/***************************************************************************
+ *            test_host_resources.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <fstream>
+#include <filesystem>
+#include "helper/test.hpp"
+#include "host_resources.hpp"
+
+using namespace BetterThreads;
+
+class TestHostResources {
+  public:
+
+    TestHostResources() : _root(std::filesystem::temp_directory_path() / "betterthreads_test_host_resources") { }
+
+    void write(std::filesystem::path const& path, String const& content) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file(path);
+        file << content;
+    }
+
+    void test_cgroup_v2_cpu_quota() {
+        HELPER_TEST_EQUALS(cgroup_v2_cpu_quota("max 100000"),0)
+        HELPER_TEST_EQUALS(cgroup_v2_cpu_quota("400000 100000\n"),4)
+        HELPER_TEST_EQUALS(cgroup_v2_cpu_quota("150000 100000"),1.5)
+        HELPER_TEST_EQUALS(cgroup_v2_cpu_quota(""),0)
+        HELPER_TEST_EQUALS(cgroup_v2_cpu_quota("garbage"),0)
+    }
+
+    void test_cgroup_v1_cpu_quota() {
+        HELPER_TEST_EQUALS(cgroup_v1_cpu_quota(-1,100000),0)
+        HELPER_TEST_EQUALS(cgroup_v1_cpu_quota(200000,100000),2)
+        HELPER_TEST_EQUALS(cgroup_v1_cpu_quota(200000,0),0)
+    }
+
+    void test_cgroup_v2_concurrency() {
+        std::filesystem::remove_all(_root);
+        write(_root / "self_cgroup", "0::/kubepods/pod1\n");
+        write(_root / "v2" / "cgroup.controllers", "cpu io memory");
+        write(_root / "v2" / "cpu.max", "max 100000");
+        HELPER_TEST_EQUALS(cgroup_concurrency((_root / "v2").string(), (_root / "self_cgroup").string()),0)
+        write(_root / "v2" / "kubepods" / "cpu.max", "350000 100000");
+        write(_root / "v2" / "kubepods" / "pod1" / "cpu.max", "max 100000");
+        HELPER_TEST_EQUALS(cgroup_concurrency((_root / "v2").string(), (_root / "self_cgroup").string()),4)
+        write(_root / "v2" / "kubepods" / "pod1" / "cpu.max", "200000 100000");
+        HELPER_TEST_EQUALS(cgroup_concurrency((_root / "v2").string(), (_root / "self_cgroup").string()),2)
+        std::filesystem::remove_all(_root);
+    }
+
+    void test_cgroup_v1_concurrency() {
+        std::filesystem::remove_all(_root);
+        write(_root / "self_cgroup", "4:memory:/docker/abc\n2:cpu,cpuacct:/docker/abc\n");
+        write(_root / "v1" / "cpu,cpuacct" / "cpu.cfs_quota_us", "-1");
+        write(_root / "v1" / "cpu,cpuacct" / "cpu.cfs_period_us", "100000");
+        HELPER_TEST_EQUALS(cgroup_concurrency((_root / "v1").string(), (_root / "self_cgroup").string()),0)
+        write(_root / "v1" / "cpu,cpuacct" / "docker" / "abc" / "cpu.cfs_quota_us", "300000");
+        write(_root / "v1" / "cpu,cpuacct" / "docker" / "abc" / "cpu.cfs_period_us", "100000");
+        HELPER_TEST_EQUALS(cgroup_concurrency((_root / "v1").string(), (_root / "self_cgroup").string()),3)
+        std::filesystem::remove_all(_root);
+    }
+
+    void test_missing_cgroup() {
+        HELPER_TEST_EQUALS(cgroup_concurrency((_root / "missing").string(), (_root / "missing_self_cgroup").string()),0)
+    }
+
+    void test_cpu_times() {
+        auto times = parse_cpu_times("cpu  100 20 30 800 50 5 5 0 0 0\ncpu0 50 10 15 400 25 2 3 0 0 0\n");
+        HELPER_TEST_EQUALS(times.total,1010)
+        HELPER_TEST_EQUALS(times.busy,160)
+        HELPER_TEST_EQUALS(parse_cpu_times("garbage").total,0)
+        CpuTimes later;
+        later.busy = times.busy + 90;
+        later.total = times.total + 100;
+        HELPER_TEST_EQUALS(cpu_utilisation(times,later),0.9)
+        HELPER_TEST_EQUALS(cpu_utilisation(later,later),0)
+    }
+
+    void test_runnable_threads() {
+        HELPER_TEST_EQUALS(parse_runnable_threads("0.50 0.40 0.30 7/512 12345\n"),7)
+        HELPER_TEST_EQUALS(parse_runnable_threads(""),0)
+    }
+
+    void test_share_worker_budget() {
+        std::filesystem::remove_all(_root);
+        std::filesystem::create_directories(_root);
+        auto const file = (_root / "budget").string();
+        HELPER_TEST_EQUALS(share_worker_budget(file,8,4),4)
+        write(_root / "budget", "1 12\n");
+        HELPER_TEST_EQUALS(share_worker_budget(file,8,4),2)
+        HELPER_TEST_EQUALS(share_worker_budget(file,8,0),0)
+        HELPER_TEST_EQUALS(share_worker_budget((_root / "missing" / "budget").string(),8,4),4)
+        std::filesystem::remove_all(_root);
+    }
+
+    void test_effective_concurrency() {
+        HELPER_TEST_ASSERT(affinity_concurrency() <= hardware_concurrency())
+        HELPER_TEST_ASSERT(effective_concurrency() <= hardware_concurrency())
+        HELPER_TEST_ASSERT(effective_concurrency() > 0)
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_cgroup_v2_cpu_quota())
+        HELPER_TEST_CALL(test_cgroup_v1_cpu_quota())
+        HELPER_TEST_CALL(test_cgroup_v2_concurrency())
+        HELPER_TEST_CALL(test_cgroup_v1_concurrency())
+        HELPER_TEST_CALL(test_missing_cgroup())
+        HELPER_TEST_CALL(test_cpu_times())
+        HELPER_TEST_CALL(test_runnable_threads())
+        HELPER_TEST_CALL(test_share_worker_budget())
+        HELPER_TEST_CALL(test_effective_concurrency())
+    }
+
+  private:
+    std::filesystem::path const _root;
+};
+
+int main() {
+    TestHostResources().test();
+    return HELPER_TEST_FAILURES;
+}
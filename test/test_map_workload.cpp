@@ -0,0 +1,212 @@
+/***************************************************************************
+ *            test_map_workload.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <memory>
+#include <random>
+#include "helper/test.hpp"
+#include "map_workload.hpp"
+
+using namespace BetterThreads;
+
+int square_with_jitter(int const& val) {
+    thread_local std::mt19937 generator(std::random_device{}());
+    std::this_thread::sleep_for(std::chrono::microseconds(std::uniform_int_distribution<int>(0,500)(generator)));
+    return val*val;
+}
+
+int add_offset(int const& val, int offset) {
+    return val + offset;
+}
+
+int throw_at_five(int const& val) {
+    if (val == 5) throw std::exception();
+    return val;
+}
+
+int throw_at_five_late(int const& val) {
+    if (val == 5) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        throw std::exception();
+    }
+    return val;
+}
+
+//! \brief A result that can be neither copied nor default constructed
+struct MoveOnlyResult {
+    explicit MoveOnlyResult(int v) : value(std::make_unique<int>(v)) { }
+    std::unique_ptr<int> value;
+};
+
+MoveOnlyResult make_move_only(int const& val) {
+    return MoveOnlyResult(val);
+}
+
+class TestMapWorkload {
+  public:
+
+    void test_construct() {
+        MapWorkload<int,int> wl(&square_with_jitter);
+        HELPER_TEST_ASSERT(wl.ordering() == MapOrdering::ORDERED)
+        HELPER_TEST_EQUALS(wl.reorder_window(),MAP_WORKLOAD_DEFAULT_REORDER_WINDOW)
+        wl.set_ordering(MapOrdering::UNORDERED);
+        wl.set_reorder_window(3);
+        HELPER_TEST_ASSERT(wl.ordering() == MapOrdering::UNORDERED)
+        HELPER_TEST_EQUALS(wl.reorder_window(),3)
+        HELPER_TEST_FAIL(wl.set_reorder_window(0))
+        wl.append({1,2});
+        HELPER_TEST_EQUALS(wl.size(),2)
+        HELPER_TEST_FAIL(wl.process())
+    }
+
+    void test_vector_output() {
+        ThreadManager::instance().set_maximum_concurrency();
+        MapWorkload<int,int,int> wl(&add_offset, 100);
+        std::vector<int> results;
+        wl.output_to(results);
+        for (int i=0; i<50; ++i) wl.append(i);
+        wl.process();
+        HELPER_TEST_EQUALS(results.size(),50)
+        for (int i=0; i<50; ++i) HELPER_TEST_EQUALS(results[static_cast<size_t>(i)],i+100)
+    }
+
+    void test_ordered_callback_output() {
+        ThreadManager::instance().set_maximum_concurrency();
+        MapWorkload<int,int> wl(&square_with_jitter);
+        List<int> results;
+        wl.output_to([&results](int&& r) { results.push_back(r); });
+        wl.set_reorder_window(4);
+        List<int> expected;
+        for (int i=0; i<100; ++i) { wl.append(i); expected.push_back(i*i); }
+        wl.process();
+        HELPER_TEST_EQUALS(results,expected)
+    }
+
+    void test_unordered_callback_output() {
+        ThreadManager::instance().set_maximum_concurrency();
+        MapWorkload<int,int> wl(&square_with_jitter);
+        std::atomic<int> sum(0);
+        wl.output_to([&sum](int&& r) { sum += r; });
+        wl.set_ordering(MapOrdering::UNORDERED);
+        for (int i=0; i<100; ++i) wl.append(i);
+        wl.process();
+        HELPER_TEST_EQUALS(sum,328350)
+    }
+
+    void test_buffer_output() {
+        ThreadManager::instance().set_maximum_concurrency();
+        MapWorkload<int,int> wl(&square_with_jitter);
+        Buffer<int> buffer(2);
+        wl.output_to(buffer);
+        for (int i=0; i<20; ++i) wl.append(i);
+        List<int> results;
+        std::thread consumer([&buffer,&results]{ for (int i=0; i<20; ++i) results.push_back(buffer.pull()); });
+        wl.process();
+        consumer.join();
+        List<int> expected;
+        for (int i=0; i<20; ++i) expected.push_back(i*i);
+        HELPER_TEST_EQUALS(results,expected)
+    }
+
+    void test_move_only_output() {
+        ThreadManager::instance().set_maximum_concurrency();
+        MapWorkload<int,MoveOnlyResult> wl(&make_move_only);
+        List<int> results;
+        wl.output_to([&results](MoveOnlyResult&& r) { results.push_back(*r.value); });
+        List<int> expected;
+        for (int i=0; i<20; ++i) { wl.append(i); expected.push_back(i); }
+        wl.process();
+        HELPER_TEST_EQUALS(results,expected)
+
+        Buffer<MoveOnlyResult> buffer(2);
+        wl.output_to(buffer);
+        for (int i=0; i<20; ++i) wl.append(i);
+        results.clear();
+        std::thread consumer([&buffer,&results]{ for (int i=0; i<20; ++i) results.push_back(*buffer.pull().value); });
+        wl.process();
+        consumer.join();
+        HELPER_TEST_EQUALS(results,expected)
+    }
+
+    void test_stop_from_ordered_callback() {
+        ThreadManager::instance().set_maximum_concurrency();
+        MapWorkload<int,int> wl(&square_with_jitter);
+        List<int> results;
+        // The callback is called without holding the locks of the workload, hence it can stop it
+        wl.output_to([&results,&wl](int&& r) { results.push_back(r); if (results.size() == 5) wl.stop(); });
+        wl.set_reorder_window(4);
+        for (int i=0; i<100; ++i) wl.append(i);
+        wl.process();
+        HELPER_TEST_ASSERT(wl.stop_requested())
+        HELPER_TEST_ASSERT(results.size() >= 5 and results.size() < 100)
+        for (size_t i=0; i<results.size(); ++i) HELPER_TEST_EQUALS(results.at(i),static_cast<int>(i*i))
+    }
+
+    void test_ordered_exception() {
+        ThreadManager::instance().set_maximum_concurrency();
+        MapWorkload<int,int> wl(&throw_at_five);
+        List<int> results;
+        wl.output_to([&results](int&& r) { results.push_back(r); });
+        wl.set_reorder_window(1);
+        for (int i=0; i<20; ++i) wl.append(i);
+        HELPER_TEST_FAIL(wl.process())
+        wl.append({1,2});
+        results.clear();
+        wl.process();
+        HELPER_TEST_EQUALS(results,List<int>({1,2}))
+    }
+
+    void test_ordered_exception_in_chunk() {
+        ThreadManager::instance().set_maximum_concurrency();
+        for (size_t run=0; run<3; ++run) {
+            MapWorkload<int,int> wl(&throw_at_five_late);
+            List<int> results;
+            wl.output_to([&results](int&& r) { results.push_back(r); });
+            wl.set_chunk_size(4);
+            wl.set_reorder_window(1);
+            for (int i=0; i<40; ++i) wl.append(i);
+            HELPER_TEST_FAIL(wl.process())
+        }
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_construct());
+        HELPER_TEST_CALL(test_vector_output());
+        HELPER_TEST_CALL(test_ordered_callback_output());
+        HELPER_TEST_CALL(test_unordered_callback_output());
+        HELPER_TEST_CALL(test_buffer_output());
+        HELPER_TEST_CALL(test_move_only_output());
+        HELPER_TEST_CALL(test_stop_from_ordered_callback());
+        HELPER_TEST_CALL(test_ordered_exception());
+        HELPER_TEST_CALL(test_ordered_exception_in_chunk());
+    }
+};
+
+int main() {
+    TestMapWorkload().test();
+    return HELPER_TEST_FAILURES;
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *            test_oversubscription_guard.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <filesystem>
+#include "helper/test.hpp"
+#include "conclog/logging.hpp"
+#include "conclog/thread_registry_interface.hpp"
+#include "oversubscription_guard.hpp"
+
+using namespace BetterThreads;
+using namespace std::chrono_literals;
+
+class ThreadRegistry : public ConcLog::ThreadRegistryInterface {
+public:
+    ThreadRegistry() : _threads_registered(0) { }
+    bool has_threads_registered() const override { return _threads_registered > 0; }
+    void set_threads_registered(unsigned int threads_registered) { _threads_registered = threads_registered; }
+private:
+    unsigned int _threads_registered;
+};
+
+class TestOversubscriptionGuard {
+  public:
+
+    void test_construct() {
+        ThreadPool pool(2);
+        OversubscriptionGuard guard(pool, 2, 10ms);
+        HELPER_TEST_EQUALS(guard.sampling_interval(),10ms)
+        HELPER_TEST_ASSERT(guard.budget_file().empty())
+        HELPER_TEST_EQUALS(guard.allowed_threads(),THREAD_POOL_UNLIMITED_ACTIVE_THREADS)
+    }
+
+    void test_update() {
+        ThreadPool pool(2);
+        {
+            OversubscriptionGuard guard(pool, 2, 10ms);
+            HELPER_TEST_EXECUTE(guard.update())
+            HELPER_TEST_ASSERT(guard.allowed_threads() >= 1)
+            std::this_thread::sleep_for(50ms);
+            HELPER_TEST_EQUALS(pool.enqueue([]{ return 1; }).get(),1)
+        }
+        HELPER_TEST_EQUALS(pool.max_active_threads(),THREAD_POOL_UNLIMITED_ACTIVE_THREADS)
+    }
+
+    void test_budget_file() {
+        auto const file = std::filesystem::temp_directory_path() / "betterthreads_test_oversubscription_guard";
+        std::filesystem::remove(file);
+        ThreadPool pool(2);
+        {
+            OversubscriptionGuard guard(pool, 1, 10ms, file.string());
+            HELPER_TEST_EQUALS(guard.budget_file(),file.string())
+            guard.update();
+            HELPER_TEST_EQUALS(guard.allowed_threads(),1)
+            HELPER_TEST_EQUALS(pool.max_active_threads(),1)
+        }
+        HELPER_TEST_EQUALS(pool.max_active_threads(),THREAD_POOL_UNLIMITED_ACTIVE_THREADS)
+        std::filesystem::remove(file);
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_construct())
+        HELPER_TEST_CALL(test_update())
+        HELPER_TEST_CALL(test_budget_file())
+    }
+};
+
+int main() {
+    ThreadRegistry registry;
+    ConcLog::Logger::instance().attach_thread_registry(&registry);
+    TestOversubscriptionGuard().test();
+    return HELPER_TEST_FAILURES;
+}
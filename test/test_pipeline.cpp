@@ -0,0 +1,174 @@
+/***************************************************************************
+ *            test_pipeline.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <random>
+#include "helper/test.hpp"
+#include "helper/container.hpp"
+#include "pipeline.hpp"
+
+using namespace BetterThreads;
+using Helper::List;
+
+std::function<std::optional<int>()> counter_up_to(int max) {
+    auto next = std::make_shared<int>(0);
+    return [next,max]() -> std::optional<int> { if (*next >= max) return std::nullopt; return ++*next; };
+}
+
+int square_with_jitter(int const& val) {
+    thread_local std::mt19937 generator(std::random_device{}());
+    std::this_thread::sleep_for(std::chrono::microseconds(std::uniform_int_distribution<int>(0,500)(generator)));
+    return val*val;
+}
+
+class TestPipeline {
+  public:
+
+    void test_construct() {
+        auto pipeline = Pipeline::source("read", counter_up_to(10))
+                .map("square", &square_with_jitter, 2)
+                .filter("even", [](int const& val) { return val % 2 == 0; })
+                .sink("write", [](int const&) { });
+        HELPER_TEST_EQUALS(pipeline.num_stages(),4)
+        HELPER_TEST_EQUALS(pipeline.buffer_capacity(),PIPELINE_DEFAULT_BUFFER_CAPACITY)
+        HELPER_TEST_EQUALS(pipeline.max_in_flight(),PIPELINE_DEFAULT_MAX_IN_FLIGHT)
+        pipeline.set_buffer_capacity(4);
+        pipeline.set_max_in_flight(16);
+        HELPER_TEST_EQUALS(pipeline.buffer_capacity(),4)
+        HELPER_TEST_EQUALS(pipeline.max_in_flight(),16)
+        HELPER_TEST_FAIL(pipeline.set_buffer_capacity(0))
+        HELPER_TEST_FAIL(pipeline.set_max_in_flight(0))
+        HELPER_TEST_ASSERT(not pipeline.stop_requested())
+    }
+
+    void test_extend_only_last() {
+        auto source = Pipeline::source("read", counter_up_to(10));
+        source.map("square", &square_with_jitter);
+        HELPER_TEST_FAIL(source.sink("write", [](int const&) { }))
+    }
+
+    void test_run_once() {
+        auto pipeline = Pipeline::source("read", counter_up_to(10)).sink("write", [](int const&) { });
+        pipeline.run();
+        HELPER_TEST_FAIL(pipeline.run())
+        HELPER_TEST_FAIL(pipeline.set_buffer_capacity(2))
+    }
+
+    void test_parallel_stages() {
+        std::atomic<int> sum = 0;
+        auto pipeline = Pipeline::source("read", counter_up_to(100))
+                .map("square", &square_with_jitter, 4)
+                .filter("even", [](int const& val) { return val % 2 == 0; }, 2)
+                .sink("write", [&sum](int const& val) { sum += val; }, 2);
+        pipeline.run();
+        int expected = 0;
+        for (int i=2; i<=100; i+=2) expected += i*i;
+        HELPER_TEST_EQUALS(sum,expected)
+    }
+
+    void test_serial_in_order() {
+        List<int> results;
+        auto pipeline = Pipeline::source("read", counter_up_to(50))
+                .map("square", &square_with_jitter, 4)
+                .filter("odd", [](int const& val) { return val % 2 == 1; }, 3)
+                .map("halve", [](int const& val) { return val / 2; }, PIPELINE_SERIAL_IN_ORDER)
+                .sink("write", [&results](int const& val) { results.push_back(val); }, PIPELINE_SERIAL_IN_ORDER);
+        pipeline.run();
+        List<int> expected;
+        for (int i=1; i<=50; i+=2) expected.push_back(i*i/2);
+        HELPER_TEST_EQUALS(results,expected)
+    }
+
+    void test_type_change() {
+        List<String> results;
+        auto pipeline = Pipeline::source("read", counter_up_to(5))
+                .map("format", [](int const& val) { return std::to_string(val); }, 2)
+                .sink("write", [&results](String const& val) { results.push_back(val); }, PIPELINE_SERIAL_IN_ORDER);
+        pipeline.run();
+        HELPER_TEST_EQUALS(results,List<String>({"1","2","3","4","5"}))
+    }
+
+    void test_backpressure() {
+        std::atomic<int> emitted = 0, consumed = 0, max_difference = 0;
+        auto generate = counter_up_to(40);
+        auto pipeline = Pipeline::source("read", [&,generate]() { auto result = generate(); if (result) ++emitted; return result; })
+                .map("square", &square_with_jitter, 2)
+                .sink("write", [&](int const&) {
+                    int difference = emitted - consumed;
+                    if (difference > max_difference) max_difference = difference;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    ++consumed;
+                });
+        pipeline.set_buffer_capacity(2);
+        pipeline.set_max_in_flight(4);
+        pipeline.run();
+        HELPER_TEST_EQUALS(consumed,40)
+        HELPER_TEST_ASSERT(max_difference <= 4)
+    }
+
+    void test_exception() {
+        std::atomic<int> consumed = 0;
+        auto pipeline = Pipeline::source("read", counter_up_to(1000))
+                .map("check", [](int const& val) { if (val == 5) throw std::exception(); return val; }, 2)
+                .map("identity", [](int const& val) { return val; }, PIPELINE_SERIAL_IN_ORDER)
+                .sink("write", [&consumed](int const&) { ++consumed; });
+        pipeline.set_buffer_capacity(2);
+        HELPER_TEST_FAIL(pipeline.run())
+        HELPER_TEST_ASSERT(consumed < 1000)
+    }
+
+    void test_stop() {
+        std::atomic<int> consumed = 0;
+        Pipeline* stoppable = nullptr;
+        // The source is run by two workers, hence the generator must be thread safe
+        auto next = std::make_shared<std::atomic<int>>(0);
+        auto pipeline = Pipeline::source("read", [next]() -> std::optional<int> { return ++*next; }, 2)
+                .map("square", [](int const& val) { return val; }, 2)
+                .sink("write", [&](int const&) { if (++consumed == 100) stoppable->stop(); });
+        stoppable = &pipeline;
+        pipeline.run();
+        HELPER_TEST_ASSERT(pipeline.stop_requested())
+        HELPER_TEST_ASSERT(consumed >= 100)
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_construct());
+        HELPER_TEST_CALL(test_extend_only_last());
+        HELPER_TEST_CALL(test_run_once());
+        HELPER_TEST_CALL(test_parallel_stages());
+        HELPER_TEST_CALL(test_serial_in_order());
+        HELPER_TEST_CALL(test_type_change());
+        HELPER_TEST_CALL(test_backpressure());
+        HELPER_TEST_CALL(test_exception());
+        HELPER_TEST_CALL(test_stop());
+    }
+};
+
+int main() {
+    TestPipeline().test();
+    return HELPER_TEST_FAILURES;
+}
@@ -0,0 +1,92 @@
+/***************************************************************************
+ *            test_sharded_set.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+#include "helper/test.hpp"
+#include "sharded_set.hpp"
+
+using namespace BetterThreads;
+
+class TestShardedSet {
+  public:
+
+    void test_construct() {
+        ShardedSet<int> set;
+        HELPER_TEST_EQUALS(set.num_shards(),SHARDED_SET_DEFAULT_NUM_SHARDS)
+        HELPER_TEST_EQUALS(set.size(),0)
+        HELPER_TEST_FAIL(ShardedSet<int>(0))
+    }
+
+    void test_insert() {
+        ShardedSet<int> set(4);
+        HELPER_TEST_ASSERT(set.insert(3))
+        HELPER_TEST_ASSERT(set.insert(7))
+        HELPER_TEST_ASSERT(not set.insert(3))
+        HELPER_TEST_ASSERT(set.contains(7))
+        HELPER_TEST_ASSERT(not set.contains(5))
+        HELPER_TEST_EQUALS(set.size(),2)
+        set.clear();
+        HELPER_TEST_EQUALS(set.size(),0)
+        HELPER_TEST_ASSERT(not set.contains(3))
+    }
+
+    void test_custom_hash() {
+        auto parity_hash = [](int const& v) { return static_cast<size_t>(v % 2); };
+        ShardedSet<int,std::function<size_t(int const&)>> set(8, parity_hash);
+        for (int i=0; i<10; ++i) set.insert(i);
+        HELPER_TEST_EQUALS(set.size(),10)
+        HELPER_TEST_ASSERT(set.contains(9))
+    }
+
+    void test_concurrent_insert() {
+        ShardedSet<int> set;
+        std::atomic<int> num_inserted(0);
+        std::vector<std::thread> threads;
+        for (int t=0; t<4; ++t)
+            threads.push_back(std::thread([&set,&num_inserted]{
+                for (int i=0; i<10000; ++i)
+                    if (set.insert(i)) ++num_inserted;
+            }));
+        for (auto& thread : threads) thread.join();
+        HELPER_TEST_EQUALS(num_inserted,10000)
+        HELPER_TEST_EQUALS(set.size(),10000)
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_construct());
+        HELPER_TEST_CALL(test_insert());
+        HELPER_TEST_CALL(test_custom_hash());
+        HELPER_TEST_CALL(test_concurrent_insert());
+    }
+};
+
+int main() {
+    TestShardedSet().test();
+    return HELPER_TEST_FAILURES;
+}
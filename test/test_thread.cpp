@@ -32,6 +32,9 @@
 #include "conclog/thread_registry_interface.hpp"
 #include "thread.hpp"
 #include "using.hpp"
+#if defined(__linux__)
+#include <pthread.h>
+#endif
 
 using namespace BetterThreads;
 using namespace Helper;
@@ -76,6 +79,62 @@ class TestThread {
         HELPER_TEST_ASSERT(thread.exception() != nullptr)
     }
 
+    void test_activate() const {
+        int a = 0;
+        Thread thread([&a] { a++; }, "thr", false);
+        HELPER_TEST_EQUALS(thread.name(),"thr")
+        std::this_thread::sleep_for(10ms);
+        HELPER_TEST_EQUALS(a,0)
+        thread.activate();
+        std::this_thread::sleep_for(10ms);
+        HELPER_TEST_EQUALS(a,1)
+        HELPER_TEST_EXECUTE(thread.activate())
+    }
+
+    void test_destroy_inactive() const {
+        int a = 0;
+        {
+            Thread thread([&a] { a++; }, "", false);
+            HELPER_TEST_EQUALS(to_string(thread.id()),thread.name())
+        }
+        HELPER_TEST_EQUALS(a,0)
+    }
+
+    void test_attributes() const {
+        ThreadAttributes attributes;
+        // Not a multiple of the page size, and larger than the usual default stack of 8MB
+        attributes.stack_size = 16*1024*1024+1;
+        attributes.set_os_name = true;
+        attributes.scheduling_class = ThreadSchedulingClass::BATCH;
+        attributes.nice = 1;
+        size_t const recursion_depth = 12000;
+        std::atomic<size_t> depth = 0;
+        std::function<void(size_t)> recurse = [&](size_t n) { volatile char buffer[1024]; buffer[n % 1024] = 1; if (n > 0) recurse(n-1); depth += static_cast<size_t>(buffer[n % 1024]); };
+        size_t native_stack_size = 0;
+        String native_name;
+        {
+            Thread thread([&] {
+#if defined(__linux__)
+                pthread_attr_t native_attributes;
+                pthread_getattr_np(pthread_self(), &native_attributes);
+                pthread_attr_getstacksize(&native_attributes, &native_stack_size);
+                pthread_attr_destroy(&native_attributes);
+                char name[16];
+                pthread_getname_np(pthread_self(), name, sizeof(name));
+                native_name = name;
+#endif
+                recurse(recursion_depth);
+            }, "attrthr", true, attributes);
+            HELPER_TEST_EQUALS(thread.attributes().stack_size,attributes.stack_size)
+            HELPER_TEST_EQUALS(thread.name(),"attrthr")
+        }
+        HELPER_TEST_EQUALS(depth,recursion_depth+1)
+#if defined(__linux__)
+        HELPER_TEST_ASSERT(native_stack_size >= attributes.stack_size)
+        HELPER_TEST_EQUALS(native_name,"attrthr")
+#endif
+    }
+
     void test_atomic_multiple_threads() const {
         size_t n_threads = 10*std::thread::hardware_concurrency();
         HELPER_TEST_PRINT(n_threads)
@@ -96,6 +155,9 @@ class TestThread {
         HELPER_TEST_CALL(test_destroy_before_completion())
         HELPER_TEST_CALL(test_task())
         HELPER_TEST_CALL(test_exception())
+        HELPER_TEST_CALL(test_activate())
+        HELPER_TEST_CALL(test_destroy_inactive())
+        HELPER_TEST_CALL(test_attributes())
         HELPER_TEST_CALL(test_atomic_multiple_threads())
     }
 
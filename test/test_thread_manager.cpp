@@ -26,6 +26,7 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <latch>
 #include <thread>
 #include "helper/test.hpp"
 #include "thread_manager.hpp"
@@ -79,12 +80,91 @@ class TestThreadManager {
         HELPER_TEST_EXECUTE(ThreadManager::instance().set_concurrency(0))
     }
 
+    void test_revive_parked_threads() {
+        ThreadManager::instance().set_concurrency(1);
+        auto id = ThreadManager::instance().enqueue([]{ return std::this_thread::get_id(); }).get();
+        ThreadManager::instance().set_concurrency(0);
+        ThreadManager::instance().set_concurrency(1);
+        HELPER_TEST_ASSERT(ThreadManager::instance().enqueue([]{ return std::this_thread::get_id(); }).get() == id)
+        ThreadManager::instance().set_concurrency(0);
+    }
+
+    void test_query_while_reducing_concurrency() {
+        ThreadManager::instance().set_concurrency(1);
+        std::latch started(1);
+        // Reducing waits for the worker to park, hence the worker must be able to query the manager meanwhile
+        auto result = ThreadManager::instance().enqueue([&started] {
+            started.count_down();
+            std::this_thread::sleep_for(50ms);
+            bool const registered = ThreadManager::instance().has_threads_registered();
+            return std::make_pair(registered, ThreadManager::instance().concurrency());
+        });
+        started.wait();
+        ThreadManager::instance().set_concurrency(0);
+        auto const [registered, concurrency] = result.get();
+        HELPER_TEST_ASSERT(not registered)
+        HELPER_TEST_EQUALS(concurrency,0)
+    }
+
+    void test_named_pools() {
+        auto& manager = ThreadManager::instance();
+        manager.set_concurrency(0);
+        HELPER_TEST_ASSERT(manager.has_pool(THREAD_POOL_DEFAULT_NAME))
+        HELPER_TEST_ASSERT(not manager.has_pool("io"))
+        HELPER_TEST_FAIL(manager.add_pool(THREAD_POOL_DEFAULT_NAME))
+        HELPER_TEST_FAIL(manager.add_pool("io",manager.maximum_concurrency()+1))
+        HELPER_TEST_EXECUTE(manager.add_pool("io"))
+        HELPER_TEST_ASSERT(manager.has_pool("io"))
+        HELPER_TEST_FAIL(manager.add_pool("io"))
+        HELPER_TEST_FAIL(manager.pool_concurrency("missing"))
+        HELPER_TEST_EQUALS(manager.pool_concurrency("io"),0)
+        auto caller_id = std::this_thread::get_id();
+        HELPER_TEST_ASSERT(manager.enqueue_on("io",[]{ return std::this_thread::get_id(); }).get() == caller_id)
+        manager.set_pool_concurrency("io",1);
+        HELPER_TEST_EQUALS(manager.pool_concurrency("io"),1)
+        HELPER_TEST_EQUALS(manager.total_concurrency(),1)
+        HELPER_TEST_ASSERT(manager.has_threads_registered())
+        HELPER_TEST_ASSERT(manager.enqueue_on("io",[]{ return std::this_thread::get_id(); }).get() != caller_id)
+        HELPER_TEST_FAIL(manager.set_concurrency(manager.maximum_concurrency()))
+        HELPER_TEST_FAIL(manager.set_logging_immediate_scheduler())
+        manager.set_concurrency(manager.maximum_concurrency()-1);
+        HELPER_TEST_EQUALS(manager.total_concurrency(),manager.maximum_concurrency())
+        manager.set_concurrency(0);
+        HELPER_TEST_EXECUTE(manager.set_maximum_concurrency())
+        HELPER_TEST_EQUALS(manager.concurrency(),manager.maximum_concurrency()-1)
+        HELPER_TEST_EQUALS(manager.total_concurrency(),manager.maximum_concurrency())
+        HELPER_TEST_EQUALS(manager.enqueue_on(THREAD_POOL_DEFAULT_NAME,[]{ return 1; }).get(),1)
+        manager.set_concurrency(0);
+        manager.set_pool_concurrency("io",0);
+        HELPER_TEST_EQUALS(manager.total_concurrency(),0)
+    }
+
+    void test_adaptive_concurrency() {
+        auto& manager = ThreadManager::instance();
+        manager.set_maximum_concurrency();
+        HELPER_TEST_ASSERT(not manager.has_adaptive_concurrency())
+        HELPER_TEST_EQUALS(manager.active_concurrency(),manager.maximum_concurrency())
+        manager.enable_adaptive_concurrency(10ms);
+        HELPER_TEST_ASSERT(manager.has_adaptive_concurrency())
+        std::this_thread::sleep_for(50ms);
+        HELPER_TEST_ASSERT(manager.active_concurrency() >= 1)
+        HELPER_TEST_EQUALS(manager.enqueue([]{ return 1; }).get(),1)
+        manager.disable_adaptive_concurrency();
+        HELPER_TEST_ASSERT(not manager.has_adaptive_concurrency())
+        HELPER_TEST_EQUALS(manager.active_concurrency(),manager.maximum_concurrency())
+        manager.set_concurrency(0);
+    }
+
     void test() {
         HELPER_TEST_CALL(test_set_concurrency())
         HELPER_TEST_CALL(test_run_task_with_one_thread())
         HELPER_TEST_CALL(test_run_task_with_multiple_threads())
         HELPER_TEST_CALL(test_run_task_with_no_threads())
         HELPER_TEST_CALL(test_change_concurrency_and_log_scheduler())
+        HELPER_TEST_CALL(test_revive_parked_threads())
+        HELPER_TEST_CALL(test_query_while_reducing_concurrency())
+        HELPER_TEST_CALL(test_named_pools())
+        HELPER_TEST_CALL(test_adaptive_concurrency())
     }
 };
 
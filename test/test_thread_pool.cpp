@@ -207,6 +207,205 @@ class TestSmartThreadPool {
         HELPER_TEST_ASSERT(pool.queue_size() > 0);
     }
 
+    void test_queue_capacity() const {
+        ThreadPool pool(0);
+        HELPER_TEST_EQUALS(pool.queue_capacity(),THREAD_POOL_UNBOUNDED_QUEUE_CAPACITY);
+        HELPER_TEST_FAIL(pool.set_queue_capacity(0));
+        pool.set_queue_capacity(2);
+        HELPER_TEST_EQUALS(pool.queue_capacity(),2);
+        pool.enqueue([]{});
+        pool.enqueue([]{});
+        HELPER_TEST_FAIL(pool.set_queue_capacity(1));
+        HELPER_TEST_EXECUTE(pool.set_queue_capacity(3));
+    }
+
+    void test_queue_full_block() const {
+        ThreadPool pool(1);
+        HELPER_TEST_ASSERT(pool.queue_full_policy() == QueueFullPolicy::BLOCK);
+        pool.set_queue_capacity(1);
+        VoidFunction fn([] { std::this_thread::sleep_for(100ms); });
+        for (size_t i=0; i<4; ++i) {
+            pool.enqueue(fn);
+            HELPER_TEST_ASSERT(pool.queue_size() <= 1);
+        }
+    }
+
+    void test_queue_full_fail() const {
+        ThreadPool pool(0);
+        pool.set_queue_capacity(1);
+        pool.set_queue_full_policy(QueueFullPolicy::FAIL);
+        pool.enqueue([]{});
+        HELPER_TEST_FAIL(pool.enqueue([]{}));
+        HELPER_TEST_EQUALS(pool.queue_size(),1);
+    }
+
+    void test_queue_full_caller_runs() const {
+        ThreadPool pool(0);
+        pool.set_queue_capacity(1);
+        pool.set_queue_full_policy(QueueFullPolicy::CALLER_RUNS);
+        pool.enqueue([]{});
+        auto caller_id = std::this_thread::get_id();
+        auto result = pool.enqueue([]{ return std::this_thread::get_id(); });
+        HELPER_TEST_ASSERT(result.get() == caller_id);
+        HELPER_TEST_EQUALS(pool.queue_size(),1);
+    }
+
+    void test_queue_full_drop_oldest() const {
+        ThreadPool pool(0);
+        pool.set_queue_capacity(1);
+        pool.set_queue_full_policy(QueueFullPolicy::DROP_OLDEST);
+        auto dropped = pool.enqueue([]{ return 1; });
+        auto kept = pool.enqueue([]{ return 2; });
+        HELPER_TEST_EQUALS(pool.queue_size(),1);
+        HELPER_TEST_FAIL(dropped.get());
+        pool.set_num_threads(1);
+        HELPER_TEST_EQUALS(kept.get(),2);
+    }
+
+    void test_lazy_activation() const {
+        ThreadPool pool(3,"lazy",true);
+        HELPER_TEST_ASSERT(pool.lazy_activation());
+        HELPER_TEST_EQUALS(pool.num_threads(),3);
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),0);
+        pool.enqueue([]{ std::this_thread::sleep_for(100ms); });
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),1);
+        pool.enqueue([]{ std::this_thread::sleep_for(100ms); });
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),2);
+        std::this_thread::sleep_for(200ms);
+        pool.enqueue([]{});
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),2);
+        HELPER_TEST_EXECUTE(pool.set_num_threads(1));
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),1);
+        HELPER_TEST_EXECUTE(pool.set_num_threads(4));
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),2);
+        pool.set_lazy_activation(false);
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),4);
+    }
+
+    void test_lazy_activation_concurrent_enqueue() const {
+        ThreadPool pool(4,"lazy",true);
+        std::atomic<size_t> num_running = 0;
+        std::atomic<bool> all_running = false;
+        auto task = [&]{
+            ++num_running;
+            auto const deadline = std::chrono::steady_clock::now() + 2s;
+            while (num_running < 4 and std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+            if (num_running == 4) all_running = true;
+        };
+        List<std::thread> enqueuers;
+        List<future<void>> results;
+        mutex results_mutex;
+        for (size_t i=0; i<4; ++i)
+            enqueuers.push_back(std::thread([&]{ auto r = pool.enqueue(task); lock_guard<mutex> lock(results_mutex); results.push_back(std::move(r)); }));
+        for (auto& e : enqueuers) e.join();
+        for (auto& r : results) r.get();
+        HELPER_TEST_ASSERT(all_running);
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),4);
+    }
+
+    void test_lazy_activation_after_growth() const {
+        ThreadPool pool(0,"lazy",true);
+        auto result = pool.enqueue([]{ return 1; });
+        pool.set_num_threads(2);
+        HELPER_TEST_EQUALS(pool.num_activated_threads(),1);
+        HELPER_TEST_EQUALS(result.get(),1);
+    }
+
+    void test_park_and_revive() const {
+        ThreadPool pool(3);
+        HELPER_TEST_EQUALS(pool.parking_timeout(),THREAD_POOL_DEFAULT_PARKING_TIMEOUT);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),0);
+        pool.set_num_threads(1);
+        HELPER_TEST_EQUALS(pool.num_threads(),1);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),2);
+        pool.set_num_threads(0);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),3);
+        auto result = pool.enqueue([]{ return 1; });
+        std::this_thread::sleep_for(100ms);
+        HELPER_TEST_EQUALS(pool.queue_size(),1);
+        pool.set_num_threads(4);
+        HELPER_TEST_EQUALS(pool.num_threads(),4);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),0);
+        HELPER_TEST_EQUALS(result.get(),1);
+    }
+
+    void test_retire_parked() const {
+        ThreadPool pool(3);
+        pool.set_parking_timeout(50ms);
+        HELPER_TEST_EQUALS(pool.parking_timeout(),50ms);
+        pool.set_num_threads(1);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),2);
+        std::this_thread::sleep_for(200ms);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),0);
+        pool.set_num_threads(2);
+        HELPER_TEST_EQUALS(pool.num_threads(),2);
+        HELPER_TEST_EQUALS(pool.enqueue([]{ return 2; }).get(),2);
+    }
+
+    void test_thread_attributes() const {
+        ThreadAttributes attributes;
+        attributes.stack_size = 256*1024;
+        ThreadPool pool(1,"attr",false,attributes);
+        HELPER_TEST_EQUALS(pool.thread_attributes().stack_size,attributes.stack_size);
+        HELPER_TEST_EQUALS(pool.enqueue([]{ return 1; }).get(),1);
+        attributes.stack_size = 0;
+        pool.set_thread_attributes(attributes);
+        pool.set_num_threads(2);
+        HELPER_TEST_EQUALS(pool.thread_attributes().stack_size,0);
+    }
+
+    void test_max_active_threads() const {
+        ThreadPool pool(3);
+        HELPER_TEST_EQUALS(pool.max_active_threads(),THREAD_POOL_UNLIMITED_ACTIVE_THREADS);
+        HELPER_TEST_FAIL(pool.set_max_active_threads(0));
+        pool.set_max_active_threads(1);
+        std::this_thread::sleep_for(100ms);
+        HELPER_TEST_EQUALS(pool.num_threads(),3);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),2);
+        std::atomic<size_t> max_concurrent = 0, concurrent = 0;
+        List<future<void>> results;
+        for (size_t i=0; i<6; ++i)
+            results.push_back(pool.enqueue([&] { size_t c = ++concurrent; if (c > max_concurrent) max_concurrent = c; std::this_thread::sleep_for(10ms); --concurrent; }));
+        for (auto& r : results) r.get();
+        HELPER_TEST_EQUALS(max_concurrent,1);
+        pool.set_max_active_threads(THREAD_POOL_UNLIMITED_ACTIVE_THREADS);
+        std::this_thread::sleep_for(100ms);
+        HELPER_TEST_EQUALS(pool.num_parked_threads(),0);
+        HELPER_TEST_EQUALS(pool.num_busy_threads(),0);
+    }
+
+    void test_caller_runs_when_saturated() const {
+        ThreadPool pool(1);
+        HELPER_TEST_EQUALS(pool.caller_runs_threshold(),THREAD_POOL_CALLER_RUNS_DISABLED);
+        pool.set_caller_runs_threshold(1);
+        HELPER_TEST_EQUALS(pool.caller_runs_threshold(),1);
+        auto caller_id = std::this_thread::get_id();
+        auto busy = pool.enqueue([]{ std::this_thread::sleep_for(100ms); return std::this_thread::get_id(); });
+        std::this_thread::sleep_for(20ms);
+        auto queued = pool.enqueue([]{ return std::this_thread::get_id(); });
+        HELPER_TEST_EQUALS(pool.queue_size(),1);
+        auto inlined = pool.enqueue([]{ return std::this_thread::get_id(); });
+        HELPER_TEST_ASSERT(inlined.get() == caller_id);
+        HELPER_TEST_EQUALS(pool.queue_size(),1);
+        HELPER_TEST_ASSERT(busy.get() != caller_id);
+        HELPER_TEST_ASSERT(queued.get() != caller_id);
+    }
+
+    void test_run_pending_task() const {
+        ThreadPool pool(1);
+        HELPER_TEST_ASSERT(not pool.run_pending_task());
+        auto caller_id = std::this_thread::get_id();
+        auto busy = pool.enqueue([]{ std::this_thread::sleep_for(100ms); return std::this_thread::get_id(); });
+        std::this_thread::sleep_for(20ms);
+        auto queued = pool.enqueue([]{ return std::this_thread::get_id(); });
+        HELPER_TEST_EQUALS(pool.queue_size(),1);
+        HELPER_TEST_ASSERT(pool.run_pending_task());
+        HELPER_TEST_EQUALS(pool.queue_size(),0);
+        HELPER_TEST_ASSERT(queued.get() == caller_id);
+        HELPER_TEST_ASSERT(not pool.run_pending_task());
+        HELPER_TEST_ASSERT(busy.get() != caller_id);
+    }
+
     void test() {
         HELPER_TEST_CALL(test_construct_thread_name());
         HELPER_TEST_CALL(test_construct());
@@ -225,6 +424,20 @@ class TestSmartThreadPool {
         HELPER_TEST_CALL(test_set_num_threads_up_dynamically());
         HELPER_TEST_CALL(test_set_num_threads_down_dynamically());
         HELPER_TEST_CALL(test_set_num_threads_to_zero_dynamically());
+        HELPER_TEST_CALL(test_queue_capacity());
+        HELPER_TEST_CALL(test_queue_full_block());
+        HELPER_TEST_CALL(test_queue_full_fail());
+        HELPER_TEST_CALL(test_queue_full_caller_runs());
+        HELPER_TEST_CALL(test_queue_full_drop_oldest());
+        HELPER_TEST_CALL(test_lazy_activation());
+        HELPER_TEST_CALL(test_lazy_activation_concurrent_enqueue());
+        HELPER_TEST_CALL(test_lazy_activation_after_growth());
+        HELPER_TEST_CALL(test_park_and_revive());
+        HELPER_TEST_CALL(test_retire_parked());
+        HELPER_TEST_CALL(test_thread_attributes());
+        HELPER_TEST_CALL(test_max_active_threads());
+        HELPER_TEST_CALL(test_caller_runs_when_saturated());
+        HELPER_TEST_CALL(test_run_pending_task());
     }
 };
 
@@ -27,6 +27,8 @@
  */
 
 #include <functional>
+#include <latch>
+#include <set>
 #include "helper/test.hpp"
 #include "helper/container.hpp"
 #include "workload.hpp"
@@ -41,6 +43,16 @@ template<class T> class SynchronisedList : public List<T> {
     mutex _mux;
 };
 
+struct CopyCounted {
+    CopyCounted(int v) : value(v) { }
+    CopyCounted(CopyCounted const& other) : value(other.value) { ++copies; }
+    CopyCounted(CopyCounted&& other) noexcept : value(other.value) { }
+    CopyCounted& operator=(CopyCounted const& other) { value = other.value; ++copies; return *this; }
+    CopyCounted& operator=(CopyCounted&& other) noexcept { value = other.value; return *this; }
+    int value;
+    static inline std::atomic<int> copies = 0;
+};
+
 using StaticWorkloadType = StaticWorkload<int,std::shared_ptr<std::atomic<int>>>;
 using DynamicWorkloadType = DynamicWorkload<int,std::shared_ptr<SynchronisedList<int>>>;
 
@@ -61,6 +73,86 @@ void square_and_store(DynamicWorkloadType::Access& wla, int const& val, std::sha
     results->append(next_val);
 }
 
+void record_thread(int const&, std::shared_ptr<SynchronisedList<std::thread::id>> ids) {
+    ids->append(std::this_thread::get_id());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+}
+
+void record_logger_level(int const&, std::shared_ptr<SynchronisedList<unsigned int>> levels) {
+    levels->append(Logger::instance().current_level());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void sum_counted(CopyCounted const& val, std::shared_ptr<std::atomic<int>> result) {
+    result->operator+=(val.value);
+}
+
+void expand_counted(DynamicWorkload<CopyCounted,std::shared_ptr<std::atomic<int>>>::Access& wla, CopyCounted const& val, std::shared_ptr<std::atomic<int>> result) {
+    result->operator+=(val.value);
+    if (val.value > 1) {
+        wla.append(CopyCounted(val.value-1));
+        wla.emplace(val.value-1);
+    }
+}
+
+void expand_tree(DynamicWorkloadType::Access& wla, int const& val, std::shared_ptr<SynchronisedList<int>> visited) {
+    visited->append(val);
+    if (val < 8) {
+        wla.append(val*2);
+        wla.append(val*2+1);
+    }
+}
+
+void accumulate_square(int const& val, long& accumulator) {
+    accumulator += val*val;
+}
+
+void add_to(long& accumulator, long const& other) {
+    accumulator += other;
+}
+
+void search_target(DynamicWorkloadType::Access& wla, int const& val, std::shared_ptr<SynchronisedList<int>> found) {
+    if (wla.stop_requested()) return;
+    if (val == 100) {
+        found->append(val);
+        wla.stop();
+    } else if (val < 1000000) {
+        wla.append(val*2);
+        wla.append(val*2+1);
+    }
+}
+
+void wait_briefly(int const&, std::shared_ptr<std::atomic<int>> count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ++*count;
+}
+
+void wait_contended(int const&, std::shared_ptr<std::atomic<int>> count) {
+    static std::atomic<int> active = 0;
+    int const num_active = ++active;
+    // The cost grows with the square of the threads running, hence the throughput is the highest with one thread
+    std::this_thread::sleep_for(std::chrono::microseconds(500*num_active*num_active));
+    --active;
+    ++*count;
+}
+
+void visit_modulo(DynamicWorkloadType::Access& wla, int const& val, std::shared_ptr<SynchronisedList<int>> visited) {
+    visited->append(val);
+    wla.append((val*3) % 101);
+    wla.emplace((val+1) % 101);
+}
+
+void visit_decreasing(DynamicWorkloadType::Access& wla, int const& val, std::shared_ptr<SynchronisedList<int>> visited) {
+    visited->append(val);
+    if (val > 10) wla.append(val-10);
+}
+
+void sum_nested(int const& val, std::shared_ptr<std::atomic<int>> result) {
+    StaticWorkloadType inner(&sum_all, result);
+    for (int i=1; i<=val; ++i) inner.append(i);
+    inner.process();
+}
+
 void progress_acknowledge(int const& val, std::shared_ptr<ProgressIndicator> indicator) {
     indicator->update_current(val);
     indicator->update_final(std::numeric_limits<int>::max());
@@ -221,16 +313,564 @@ class TestWorkload {
         HELPER_TEST_EQUALS(result->size(),5)
     }
 
+    void test_concurrent_processing_with_caller_runs() {
+        ThreadManager::instance().set_maximum_concurrency();
+        ThreadManager::instance().set_caller_runs_threshold(1);
+        auto result = std::make_shared<std::atomic<int>>();
+        *result = 0;
+        StaticWorkloadType wl(&sum_all, result);
+        List<int> elements;
+        for (int i=1; i<=100; ++i) elements.push_back(i);
+        wl.append(elements);
+        wl.process();
+        HELPER_TEST_EQUALS(*result,5050)
+        ThreadManager::instance().set_caller_runs_threshold(THREAD_POOL_CALLER_RUNS_DISABLED);
+    }
+
+    void test_calling_thread_participates() {
+        ThreadManager::instance().set_concurrency(1);
+        auto ids = std::make_shared<SynchronisedList<std::thread::id>>();
+        StaticWorkload<int,std::shared_ptr<SynchronisedList<std::thread::id>>> wl(&record_thread, ids);
+        for (int i=0; i<50; ++i) wl.append(i);
+        wl.process();
+        HELPER_TEST_EQUALS(ids->size(),50)
+        std::set<std::thread::id> distinct(ids->begin(),ids->end());
+        HELPER_TEST_ASSERT(distinct.contains(std::this_thread::get_id()))
+        HELPER_TEST_ASSERT(distinct.size() <= 2)
+    }
+
+    void test_chunk_size() {
+        ThreadManager::instance().set_concurrency(0);
+        auto result = std::make_shared<std::atomic<int>>();
+        StaticWorkloadType wl(&sum_all, result);
+        HELPER_TEST_EQUALS(wl.chunk_size(),1)
+        wl.set_chunk_size(WORKLOAD_ADAPTIVE_CHUNK_SIZE);
+        HELPER_TEST_EQUALS(wl.chunk_size(),WORKLOAD_ADAPTIVE_CHUNK_SIZE)
+    }
+
+    void test_fixed_chunk_processing() {
+        ThreadManager::instance().set_maximum_concurrency();
+        std::shared_ptr<SynchronisedList<int>> result = std::make_shared<SynchronisedList<int>>();
+        result->append(2);
+        result->append(3);
+        DynamicWorkloadType wl(&progress_acknowledge, &square_and_store, result);
+        wl.set_chunk_size(3);
+        wl.append({2,3});
+        wl.process();
+        HELPER_TEST_EQUALS(result->size(),10)
+    }
+
+    void test_adaptive_chunk_processing() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto result = std::make_shared<std::atomic<int>>();
+        *result = 0;
+        StaticWorkloadType wl(&sum_all, result);
+        wl.set_chunk_size(WORKLOAD_ADAPTIVE_CHUNK_SIZE);
+        for (int i=0; i<100000; ++i) wl.append(i%3);
+        wl.process();
+        HELPER_TEST_EQUALS(*result,99999)
+        HELPER_TEST_EQUALS(wl.size(),0)
+    }
+
+    void test_throw_exception_in_chunk() {
+        ThreadManager::instance().set_maximum_concurrency();
+        std::shared_ptr<SynchronisedList<int>> result = std::make_shared<SynchronisedList<int>>();
+        DynamicWorkloadType wl(&progress_acknowledge, &throw_exception_immediately, result);
+        wl.set_chunk_size(4);
+        wl.append({1,2,3,4,5,6,7,8,9});
+        HELPER_TEST_FAIL(wl.process())
+    }
+
+    void test_progress_interval() {
+        ThreadManager::instance().set_concurrency(0);
+        Logger::instance().configuration().set_verbosity(2);
+        auto result = std::make_shared<std::atomic<int>>(0);
+        StaticWorkloadType wl(&sum_all, result);
+        HELPER_TEST_ASSERT(wl.progress_interval() == WORKLOAD_DEFAULT_PROGRESS_INTERVAL)
+        wl.set_progress_interval(std::chrono::hours(1));
+        HELPER_TEST_ASSERT(wl.progress_interval() == std::chrono::hours(1))
+        for (int i=0; i<1000; ++i) wl.append(1);
+        wl.process();
+        HELPER_TEST_EQUALS(*result,1000)
+        Logger::instance().configuration().set_verbosity(0);
+    }
+
+    void test_logger_level_propagation() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto levels = std::make_shared<SynchronisedList<unsigned int>>();
+        StaticWorkload<int,std::shared_ptr<SynchronisedList<unsigned int>>> wl(&record_logger_level, levels);
+        for (unsigned int level=1; level<=2; ++level) {
+            levels->clear();
+            Logger::instance().increase_level(1);
+            for (int i=0; i<20; ++i) wl.append(i);
+            wl.process();
+            HELPER_TEST_EQUALS(levels->size(),20)
+            for (auto l : *levels) HELPER_TEST_EQUALS(l,level)
+        }
+        Logger::instance().decrease_level(2);
+    }
+
+    void test_append_without_copies() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto result = std::make_shared<std::atomic<int>>(0);
+        StaticWorkload<CopyCounted,std::shared_ptr<std::atomic<int>>> wl(&sum_counted, result);
+        CopyCounted::copies = 0;
+        wl.append(CopyCounted(1));
+        wl.emplace(2);
+        HELPER_TEST_EQUALS(wl.size(),2)
+        wl.process();
+        HELPER_TEST_EQUALS(*result,3)
+        HELPER_TEST_EQUALS(CopyCounted::copies,0)
+    }
+
+    void test_dynamic_append_without_copies() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto result = std::make_shared<std::atomic<int>>(0);
+        DynamicWorkload<CopyCounted,std::shared_ptr<std::atomic<int>>> wl([](CopyCounted const&, std::shared_ptr<ProgressIndicator>){}, &expand_counted, result);
+        CopyCounted::copies = 0;
+        wl.emplace(3);
+        wl.process();
+        HELPER_TEST_EQUALS(*result,3+2*2+4*1)
+        HELPER_TEST_EQUALS(CopyCounted::copies,0)
+    }
+
+    void test_scheduling_policy() {
+        ThreadManager::instance().set_concurrency(0);
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        DynamicWorkloadType wl(&progress_acknowledge, &expand_tree, visited);
+        HELPER_TEST_ASSERT(wl.scheduling_policy() == WorkloadSchedulingPolicy::FIFO)
+        HELPER_TEST_EQUALS(wl.breadth_bound(),WORKLOAD_DEFAULT_BREADTH_BOUND)
+        wl.set_scheduling_policy(WorkloadSchedulingPolicy::BOUNDED_BREADTH);
+        wl.set_breadth_bound(4);
+        HELPER_TEST_ASSERT(wl.scheduling_policy() == WorkloadSchedulingPolicy::BOUNDED_BREADTH)
+        HELPER_TEST_EQUALS(wl.breadth_bound(),4)
+        HELPER_TEST_FAIL(wl.set_breadth_bound(0))
+    }
+
+    void test_fifo_scheduling() {
+        ThreadManager::instance().set_concurrency(0);
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        DynamicWorkloadType wl(&progress_acknowledge, &expand_tree, visited);
+        wl.append(1);
+        wl.process();
+        HELPER_TEST_EQUALS(*visited,List<int>({1,2,3,4,5,6,7,8,9,10,11,12,13,14,15}))
+    }
+
+    void test_lifo_scheduling() {
+        ThreadManager::instance().set_concurrency(0);
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        DynamicWorkloadType wl(&progress_acknowledge, &expand_tree, visited);
+        wl.set_scheduling_policy(WorkloadSchedulingPolicy::LIFO);
+        wl.append(1);
+        wl.process();
+        HELPER_TEST_EQUALS(*visited,List<int>({1,3,7,15,14,6,13,12,2,5,11,10,4,9,8}))
+    }
+
+    void test_bounded_breadth_scheduling() {
+        ThreadManager::instance().set_concurrency(0);
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        DynamicWorkloadType wl(&progress_acknowledge, &expand_tree, visited);
+        wl.set_scheduling_policy(WorkloadSchedulingPolicy::BOUNDED_BREADTH);
+        wl.set_breadth_bound(2);
+        wl.append(1);
+        wl.process();
+        HELPER_TEST_EQUALS(*visited,List<int>({1,2,5,11,10,3,7,15,14,4,9,6,13,8,12}))
+    }
+
+    void test_concurrent_depth_first_scheduling() {
+        ThreadManager::instance().set_maximum_concurrency();
+        for (auto policy : {WorkloadSchedulingPolicy::LIFO, WorkloadSchedulingPolicy::BOUNDED_BREADTH}) {
+            auto visited = std::make_shared<SynchronisedList<int>>();
+            DynamicWorkloadType wl(&progress_acknowledge, &expand_tree, visited);
+            wl.set_scheduling_policy(policy);
+            wl.set_breadth_bound(2);
+            wl.append({1,1,1,1});
+            wl.process();
+            HELPER_TEST_EQUALS(visited->size(),60)
+        }
+    }
+
+    void test_serial_reduction() {
+        ThreadManager::instance().set_concurrency(0);
+        ReducingWorkload<int,long> wl(&accumulate_square, 0, &add_to);
+        HELPER_TEST_EQUALS(wl.result(),0)
+        wl.append({1,2,3});
+        HELPER_TEST_EQUALS(wl.reduce(),14)
+        HELPER_TEST_EQUALS(wl.result(),14)
+    }
+
+    void test_concurrent_reduction() {
+        ThreadManager::instance().set_maximum_concurrency();
+        ReducingWorkload<int,long> wl(&accumulate_square, 0, &add_to);
+        for (int i=1; i<=1000; ++i) wl.append(i);
+        HELPER_TEST_EQUALS(wl.reduce(),333833500)
+        for (int i=1; i<=10; ++i) wl.append(i);
+        wl.process();
+        HELPER_TEST_EQUALS(wl.result(),385)
+    }
+
+    void test_stop_from_task() {
+        ThreadManager::instance().set_maximum_concurrency();
+        for (auto policy : {WorkloadSchedulingPolicy::FIFO, WorkloadSchedulingPolicy::LIFO}) {
+            auto found = std::make_shared<SynchronisedList<int>>();
+            DynamicWorkloadType wl(&progress_acknowledge, &search_target, found);
+            wl.set_scheduling_policy(policy);
+            wl.append(1);
+            wl.process();
+            HELPER_TEST_ASSERT(wl.stop_requested())
+            HELPER_TEST_EQUALS(*found,List<int>({100}))
+            HELPER_TEST_EQUALS(wl.size(),0)
+        }
+    }
+
+    void test_stop_from_outside() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto count = std::make_shared<std::atomic<int>>(0);
+        std::latch started(1);
+        std::atomic<bool> signalled = false;
+        StaticWorkloadType wl([&](int const& val, std::shared_ptr<std::atomic<int>> c) {
+            if (not signalled.exchange(true)) started.count_down();
+            wait_briefly(val, c);
+        }, count);
+        for (int i=0; i<10000; ++i) wl.append(i);
+        std::thread stopper([&]{ started.wait(); wl.stop(); });
+        wl.process();
+        stopper.join();
+        HELPER_TEST_ASSERT(wl.stop_requested())
+        HELPER_TEST_ASSERT(*count < 10000)
+        HELPER_TEST_EQUALS(wl.size(),0)
+        *count = 0;
+        wl.append({1,2,3});
+        wl.process();
+        HELPER_TEST_ASSERT(not wl.stop_requested())
+        HELPER_TEST_EQUALS(*count,3)
+    }
+
+    void test_stop_from_static_task() {
+        for (size_t concurrency : std::initializer_list<size_t>{0, ThreadManager::instance().maximum_concurrency()}) {
+            ThreadManager::instance().set_concurrency(concurrency);
+            auto count = std::make_shared<std::atomic<int>>(0);
+            StaticWorkloadType* self = nullptr;
+            StaticWorkloadType wl([&self](int const& val, std::shared_ptr<std::atomic<int>> c) {
+                ++*c;
+                if (val == 10) self->stop();
+            }, count);
+            self = &wl;
+            for (int i=0; i<1000; ++i) wl.append(i);
+            wl.process();
+            HELPER_TEST_ASSERT(wl.stop_requested())
+            HELPER_TEST_ASSERT(*count < 1000)
+            HELPER_TEST_EQUALS(wl.size(),0)
+        }
+    }
+
+    void test_stop_before_processing() {
+        ThreadManager::instance().set_concurrency(0);
+        auto count = std::make_shared<std::atomic<int>>(0);
+        StaticWorkloadType wl(&wait_briefly, count);
+        wl.append({1,2,3,4,5});
+        wl.stop();
+        HELPER_TEST_ASSERT(not wl.stop_requested())
+        HELPER_TEST_EQUALS(wl.size(),5)
+        wl.process();
+        HELPER_TEST_EQUALS(*count,5)
+    }
+
+    void test_stop_within_chunk() {
+        ThreadManager::instance().set_concurrency(0);
+        auto count = std::make_shared<std::atomic<int>>(0);
+        StaticWorkloadType* self = nullptr;
+        StaticWorkloadType wl([&self](int const&, std::shared_ptr<std::atomic<int>> c) {
+            if (++*c == 3) self->stop();
+        }, count);
+        self = &wl;
+        wl.set_chunk_size(20);
+        for (int i=0; i<20; ++i) wl.append(i);
+        wl.process();
+        HELPER_TEST_EQUALS(*count,3)
+        HELPER_TEST_EQUALS(wl.statistics().num_completed,3)
+    }
+
+    void test_deduplication() {
+        for (size_t concurrency : std::initializer_list<size_t>{0, ThreadManager::instance().maximum_concurrency()}) {
+            ThreadManager::instance().set_concurrency(concurrency);
+            auto visited = std::make_shared<SynchronisedList<int>>();
+            DedupDynamicWorkload<int,std::shared_ptr<SynchronisedList<int>>> wl(&progress_acknowledge, &visit_modulo, visited);
+            wl.append({1,1,2});
+            HELPER_TEST_EQUALS(wl.size(),2)
+            wl.process();
+            HELPER_TEST_EQUALS(visited->size(),101)
+            HELPER_TEST_EQUALS(wl.num_visited(),101)
+            std::set<int> distinct(visited->begin(),visited->end());
+            HELPER_TEST_EQUALS(distinct.size(),101)
+            wl.append(5);
+            HELPER_TEST_EQUALS(wl.size(),0)
+            wl.clear_visited();
+            wl.emplace(5);
+            HELPER_TEST_EQUALS(wl.size(),1)
+        }
+    }
+
+    void test_priority_order() {
+        ThreadManager::instance().set_concurrency(0);
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        PriorityWorkload<int,std::less<int>,std::shared_ptr<SynchronisedList<int>>> wl(&progress_acknowledge, &visit_decreasing, visited);
+        wl.append({3,25,14,1});
+        wl.process();
+        HELPER_TEST_EQUALS(*visited,List<int>({25,15,14,5,4,3,1}))
+    }
+
+    void test_reverse_priority_order() {
+        ThreadManager::instance().set_concurrency(0);
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        PriorityWorkload<int,std::greater<int>,std::shared_ptr<SynchronisedList<int>>> wl(&progress_acknowledge, &visit_decreasing, visited);
+        wl.append({3,25,14,1});
+        wl.process();
+        HELPER_TEST_EQUALS(*visited,List<int>({1,3,14,4,25,15,5}))
+    }
+
+    void test_concurrent_priority() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        auto by_last_digit = [](int const& a, int const& b) { return a % 10 < b % 10; };
+        PriorityWorkload<int,std::function<bool(int const&, int const&)>,std::shared_ptr<SynchronisedList<int>>> wl(by_last_digit, &progress_acknowledge, &visit_decreasing, visited);
+        wl.set_chunk_size(WORKLOAD_ADAPTIVE_CHUNK_SIZE);
+        for (int i=1; i<=100; ++i) wl.append(i*7);
+        wl.process();
+        size_t expected = 0;
+        for (int i=1; i<=100; ++i) expected += static_cast<size_t>((i*7-1)/10+1);
+        HELPER_TEST_EQUALS(visited->size(),expected)
+    }
+
+    void test_admission_settings() {
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        DynamicWorkloadType wl(&progress_acknowledge, &expand_tree, visited);
+        HELPER_TEST_EQUALS(wl.pending_limit(),WORKLOAD_UNLIMITED_PENDING)
+        HELPER_TEST_EQUALS(wl.pending_byte_budget(),WORKLOAD_UNLIMITED_PENDING)
+        HELPER_TEST_ASSERT(wl.admission_policy() == WorkloadAdmissionPolicy::BLOCK)
+        wl.set_pending_limit(3);
+        wl.set_pending_byte_budget(64, [](int const&) { return sizeof(int); });
+        wl.set_admission_policy(WorkloadAdmissionPolicy::INLINE);
+        HELPER_TEST_EQUALS(wl.pending_limit(),3)
+        HELPER_TEST_EQUALS(wl.pending_byte_budget(),64)
+        HELPER_TEST_ASSERT(wl.admission_policy() == WorkloadAdmissionPolicy::INLINE)
+        HELPER_TEST_FAIL(wl.set_pending_limit(0))
+    }
+
+    void test_inline_admission() {
+        ThreadManager::instance().set_concurrency(0);
+        auto visited = std::make_shared<SynchronisedList<int>>();
+        DynamicWorkloadType wl(&progress_acknowledge, &expand_tree, visited);
+        wl.set_pending_limit(1);
+        wl.set_admission_policy(WorkloadAdmissionPolicy::INLINE);
+        wl.append(1);
+        wl.process();
+        HELPER_TEST_EQUALS(*visited,List<int>({1,3,6,12,13,7,14,15,2,5,10,11,4,9,8}))
+    }
+
+    void test_blocking_admission() {
+        for (size_t concurrency : std::initializer_list<size_t>{1, ThreadManager::instance().maximum_concurrency()}) {
+            ThreadManager::instance().set_concurrency(concurrency);
+            auto visited = std::make_shared<SynchronisedList<int>>();
+            std::atomic<size_t> max_size = 0;
+            DynamicWorkloadType* self = nullptr;
+            // Only the root appends, hence the drainers are never blocked and the limit must hold
+            DynamicWorkloadType wl(&progress_acknowledge, [&](DynamicWorkloadType::Access& wla, int const& val, std::shared_ptr<SynchronisedList<int>> v) {
+                v->append(val);
+                if (val > 0) return;
+                for (int i=1; i<=20; ++i) {
+                    wla.append(i);
+                    max_size = std::max<size_t>(max_size, self->size());
+                }
+            }, visited);
+            self = &wl;
+            wl.set_pending_limit(2);
+            wl.append(0);
+            wl.process();
+            HELPER_TEST_EQUALS(visited->size(),21)
+            HELPER_TEST_ASSERT(max_size <= 2)
+        }
+    }
+
+    void test_byte_budget_admission() {
+        ThreadManager::instance().set_maximum_concurrency();
+        for (auto policy : {WorkloadAdmissionPolicy::BLOCK, WorkloadAdmissionPolicy::INLINE}) {
+            auto visited = std::make_shared<SynchronisedList<int>>();
+            std::atomic<size_t> max_size = 0;
+            DynamicWorkloadType* self = nullptr;
+            // Only the root appends, hence the drainers are never blocked and the limit must hold
+            DynamicWorkloadType wl(&progress_acknowledge, [&](DynamicWorkloadType::Access& wla, int const& val, std::shared_ptr<SynchronisedList<int>> v) {
+                v->append(val);
+                if (val > 0) return;
+                for (int i=1; i<=20; ++i) {
+                    wla.append(i);
+                    max_size = std::max<size_t>(max_size, self->size());
+                }
+            }, visited);
+            self = &wl;
+            wl.set_admission_policy(policy);
+            wl.set_pending_byte_budget(2*sizeof(int), [](int const&) { return sizeof(int); });
+            wl.append(0);
+            wl.process();
+            HELPER_TEST_EQUALS(visited->size(),21)
+            HELPER_TEST_ASSERT(max_size <= 2)
+        }
+    }
+
+    void test_blocking_admission_of_children() {
+        for (size_t concurrency : std::initializer_list<size_t>{1, ThreadManager::instance().maximum_concurrency()}) {
+            ThreadManager::instance().set_concurrency(concurrency);
+            for (bool byte_budget : {false, true}) {
+                auto visited = std::make_shared<SynchronisedList<int>>();
+                std::atomic<size_t> max_size = 0;
+                DynamicWorkloadType* self = nullptr;
+                // Every task appends its own children, hence all the processing threads can be blocked appending
+                DynamicWorkloadType wl(&progress_acknowledge, [&](DynamicWorkloadType::Access& wla, int const& val, std::shared_ptr<SynchronisedList<int>> v) {
+                    v->append(val);
+                    if (val >= 1024) return;
+                    for (int child : {val*2, val*2+1}) {
+                        wla.append(child);
+                        max_size = std::max<size_t>(max_size, self->size());
+                    }
+                }, visited);
+                self = &wl;
+                if (byte_budget) wl.set_pending_byte_budget(4*sizeof(int), [](int const&) { return sizeof(int); });
+                else wl.set_pending_limit(4);
+                wl.append(1);
+                wl.process();
+                HELPER_TEST_EQUALS(visited->size(),2047)
+                HELPER_TEST_ASSERT(max_size <= 4)
+            }
+        }
+    }
+
+    void test_nested_processing() {
+        for (size_t concurrency : std::initializer_list<size_t>{1, 2}) {
+            ThreadManager::instance().set_concurrency(std::min(concurrency,ThreadManager::instance().maximum_concurrency()));
+            auto result = std::make_shared<std::atomic<int>>(0);
+            StaticWorkloadType outer(&sum_nested, result);
+            for (int i=0; i<8; ++i) outer.append(10);
+            outer.process();
+            HELPER_TEST_EQUALS(*result,440)
+        }
+    }
+
+    void test_unrelated_tasks_not_run_by_caller() {
+        ThreadManager::instance().set_concurrency(1);
+        std::latch release(1);
+        std::atomic<bool> unrelated_run = false;
+        auto blocker = ThreadManager::instance().enqueue([&release] { release.wait(); });
+        auto unrelated = ThreadManager::instance().enqueue([&unrelated_run] { unrelated_run = true; });
+        // The drainers are queued behind the unrelated task, hence the calling thread processes all the elements
+        auto count = std::make_shared<std::atomic<int>>(0);
+        StaticWorkloadType wl(&wait_briefly, count);
+        for (int i=0; i<20; ++i) wl.append(i);
+        wl.process();
+        HELPER_TEST_EQUALS(*count,20)
+        HELPER_TEST_ASSERT(not unrelated_run)
+        release.count_down();
+        blocker.get();
+        unrelated.get();
+        HELPER_TEST_ASSERT(unrelated_run)
+        ThreadManager::instance().set_concurrency(0);
+    }
+
+    void test_change_concurrency_while_processing() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto count = std::make_shared<std::atomic<int>>(0);
+        StaticWorkloadType wl(&wait_briefly, count);
+        for (int i=0; i<200; ++i) wl.append(i);
+        std::thread changer([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            ThreadManager::instance().set_concurrency(0);
+            ThreadManager::instance().set_maximum_concurrency();
+        });
+        wl.process();
+        changer.join();
+        HELPER_TEST_EQUALS(*count,200)
+        ThreadManager::instance().set_concurrency(0);
+    }
+
+    void test_auto_tune_concurrency() {
+        ThreadManager::instance().set_maximum_concurrency();
+        auto count = std::make_shared<std::atomic<int>>(0);
+        StaticWorkloadType wl(&wait_briefly, count);
+        HELPER_TEST_ASSERT(not wl.auto_tunes_concurrency())
+        HELPER_TEST_EQUALS(wl.tuned_concurrency(),0)
+        wl.set_auto_tune_concurrency(true);
+        HELPER_TEST_ASSERT(wl.auto_tunes_concurrency())
+        for (size_t run=0; run<2; ++run) {
+            for (int i=0; i<300; ++i) wl.append(i);
+            wl.process();
+            HELPER_TEST_EQUALS(*count,300*static_cast<int>(run+1))
+            HELPER_TEST_ASSERT(wl.tuned_concurrency() >= 1)
+            HELPER_TEST_ASSERT(wl.tuned_concurrency() <= ThreadManager::instance().concurrency()+1)
+        }
+        ThreadManager::instance().set_concurrency(0);
+    }
+
+    void test_auto_tune_contended_concurrency() {
+        // Limited for the cost of the elements to stay low at the highest level
+        ThreadManager::instance().set_concurrency(std::min<size_t>(3, ThreadManager::instance().maximum_concurrency()));
+        auto count = std::make_shared<std::atomic<int>>(0);
+        StaticWorkloadType wl(&wait_contended, count);
+        wl.set_auto_tune_concurrency(true);
+        // Additional threads lower the throughput, hence they are released down to the calling one
+        for (size_t run=0; run<2; ++run) {
+            for (int i=0; i<600; ++i) wl.append(i);
+            wl.process();
+            HELPER_TEST_EQUALS(*count,600*static_cast<int>(run+1))
+            HELPER_TEST_EQUALS(wl.tuned_concurrency(),1)
+        }
+        ThreadManager::instance().set_concurrency(0);
+    }
+
     void test() {
         HELPER_TEST_CALL(test_construct_static())
         HELPER_TEST_CALL(test_construct_dynamic())
         HELPER_TEST_CALL(test_append())
+        HELPER_TEST_CALL(test_append_without_copies())
+        HELPER_TEST_CALL(test_dynamic_append_without_copies())
         HELPER_TEST_CALL(test_process_nothing())
         HELPER_TEST_CALL(test_serial_processing_static())
         HELPER_TEST_CALL(test_serial_processing_dynamic())
         HELPER_TEST_CALL(test_concurrent_processing_static())
         HELPER_TEST_CALL(test_concurrent_processing_dynamic())
+        HELPER_TEST_CALL(test_concurrent_processing_with_caller_runs())
+        HELPER_TEST_CALL(test_calling_thread_participates())
+        HELPER_TEST_CALL(test_logger_level_propagation())
+        HELPER_TEST_CALL(test_chunk_size())
+        HELPER_TEST_CALL(test_fixed_chunk_processing())
+        HELPER_TEST_CALL(test_adaptive_chunk_processing())
+        HELPER_TEST_CALL(test_throw_exception_in_chunk())
+        HELPER_TEST_CALL(test_scheduling_policy())
+        HELPER_TEST_CALL(test_fifo_scheduling())
+        HELPER_TEST_CALL(test_lifo_scheduling())
+        HELPER_TEST_CALL(test_bounded_breadth_scheduling())
+        HELPER_TEST_CALL(test_concurrent_depth_first_scheduling())
+        HELPER_TEST_CALL(test_serial_reduction())
+        HELPER_TEST_CALL(test_concurrent_reduction())
+        HELPER_TEST_CALL(test_stop_from_task())
+        HELPER_TEST_CALL(test_stop_from_outside())
+        HELPER_TEST_CALL(test_stop_from_static_task())
+        HELPER_TEST_CALL(test_stop_before_processing())
+        HELPER_TEST_CALL(test_stop_within_chunk())
+        HELPER_TEST_CALL(test_deduplication())
+        HELPER_TEST_CALL(test_priority_order())
+        HELPER_TEST_CALL(test_reverse_priority_order())
+        HELPER_TEST_CALL(test_concurrent_priority())
+        HELPER_TEST_CALL(test_admission_settings())
+        HELPER_TEST_CALL(test_inline_admission())
+        HELPER_TEST_CALL(test_blocking_admission())
+        HELPER_TEST_CALL(test_byte_budget_admission())
+        HELPER_TEST_CALL(test_blocking_admission_of_children())
+        HELPER_TEST_CALL(test_nested_processing())
+        HELPER_TEST_CALL(test_unrelated_tasks_not_run_by_caller())
+        HELPER_TEST_CALL(test_change_concurrency_while_processing())
+        HELPER_TEST_CALL(test_auto_tune_concurrency())
+        HELPER_TEST_CALL(test_auto_tune_contended_concurrency())
         HELPER_TEST_CALL(test_print_hold())
+        HELPER_TEST_CALL(test_progress_interval())
         HELPER_TEST_CALL(test_throw_serial_exception_immediately())
         HELPER_TEST_CALL(test_throw_serial_exception_later())
         HELPER_TEST_CALL(test_throw_concurrent_exception_immediately())
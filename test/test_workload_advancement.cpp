@@ -26,6 +26,8 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <thread>
+#include <vector>
 #include "helper/test.hpp"
 #include "workload_advancement.hpp"
 
@@ -81,11 +83,36 @@ class TestWorkloadAdvancement {
         HELPER_TEST_EQUALS(wp.completion_rate(),0.25);
     }
 
+    void test_concurrent_advance() {
+        WorkloadAdvancement wp;
+        const size_t num_threads = 4;
+        const size_t num_elements = 10000;
+        std::vector<std::thread> threads;
+        std::atomic<bool> finished_early(false);
+        for (size_t t=0; t<num_threads; ++t) {
+            threads.push_back(std::thread([&wp,&finished_early]{
+                for (size_t i=0; i<num_elements; ++i) {
+                    wp.add_to_waiting();
+                    wp.add_to_processing();
+                    if (wp.has_finished()) finished_early = true;
+                    wp.add_to_completed();
+                }
+            }));
+        }
+        for (auto& thread : threads) thread.join();
+        HELPER_TEST_ASSERT(not finished_early)
+        HELPER_TEST_EQUALS(wp.completed(),num_threads*num_elements)
+        HELPER_TEST_EQUALS(wp.waiting(),0)
+        HELPER_TEST_EQUALS(wp.processing(),0)
+        HELPER_TEST_ASSERT(wp.has_finished())
+    }
+
     void test() {
         HELPER_TEST_CALL(test_creation());
         HELPER_TEST_CALL(test_advance());
         HELPER_TEST_CALL(test_finished());
         HELPER_TEST_CALL(test_invalid_transitions());
+        HELPER_TEST_CALL(test_concurrent_advance());
     }
 
 };
@@ -0,0 +1,146 @@
+/***************************************************************************
+ *            test_workload_concurrency_tuner.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <functional>
+#include "helper/test.hpp"
+#include "workload_concurrency_tuner.hpp"
+
+using namespace BetterThreads;
+
+//! \brief Record the throughput given by \a f at each level until settled, returning the number of measurements
+size_t tune(WorkloadConcurrencyTuner& tuner, std::function<double(size_t)> const& f) {
+    size_t num_measurements = 0;
+    while (not tuner.settled()) {
+        tuner.record(f(tuner.level()));
+        ++num_measurements;
+    }
+    return num_measurements;
+}
+
+class TestWorkloadConcurrencyTuner {
+  public:
+
+    void test_construct() {
+        WorkloadConcurrencyTuner tuner;
+        HELPER_TEST_EQUALS(tuner.level(),0)
+        HELPER_TEST_ASSERT(not tuner.settled())
+        HELPER_TEST_FAIL(tuner.start(0))
+    }
+
+    void test_single_level() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(1);
+        HELPER_TEST_ASSERT(tuner.settled())
+        HELPER_TEST_EQUALS(tuner.level(),1)
+    }
+
+    void test_linear_scaling() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(16);
+        HELPER_TEST_EQUALS(tuner.level(),16)
+        tune(tuner, [](size_t level) { return 100.0*static_cast<double>(level); });
+        HELPER_TEST_EQUALS(tuner.level(),16)
+        HELPER_TEST_EQUALS(tuner.best_level(),16)
+    }
+
+    void test_interior_peak() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(16);
+        auto num_measurements = tune(tuner, [](size_t level) { return 100.0/(1.0+std::abs(static_cast<double>(level)-4.0)); });
+        HELPER_TEST_EQUALS(tuner.level(),4)
+        HELPER_TEST_ASSERT(num_measurements < 16)
+    }
+
+    void test_flat_throughput() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(8);
+        tune(tuner, [](size_t) { return 100.0; });
+        HELPER_TEST_EQUALS(tuner.level(),1)
+    }
+
+    void test_decreasing_throughput() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(16);
+        tune(tuner, [](size_t level) { return 1000.0/static_cast<double>(level); });
+        HELPER_TEST_EQUALS(tuner.level(),1)
+    }
+
+    void test_gradual_decline() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(16);
+        // Each lower level loses less than the tolerance, but the losses must not accumulate
+        tune(tuner, [](size_t level) { return 100.0*std::pow(0.97, static_cast<double>(16-level)); });
+        HELPER_TEST_ASSERT(tuner.level() >= 14 and tuner.level() < 16)
+    }
+
+    void test_restart_from_settled() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(16);
+        tune(tuner, [](size_t level) { return 100.0/(1.0+std::abs(static_cast<double>(level)-6.0)); });
+        HELPER_TEST_EQUALS(tuner.level(),6)
+        tuner.start(16);
+        HELPER_TEST_ASSERT(not tuner.settled())
+        HELPER_TEST_EQUALS(tuner.level(),6)
+        tune(tuner, [](size_t level) { return 100.0/(1.0+std::abs(static_cast<double>(level)-7.0)); });
+        HELPER_TEST_EQUALS(tuner.level(),7)
+        tuner.start(3);
+        HELPER_TEST_EQUALS(tuner.level(),3)
+    }
+
+    void test_restart_from_unsettled() {
+        WorkloadConcurrencyTuner tuner;
+        tuner.start(16);
+        auto const peak_at_4 = [](size_t level) { return 100.0/(1.0+std::abs(static_cast<double>(level)-4.0)); };
+        for (size_t i=0; i<3; ++i) tuner.record(peak_at_4(tuner.level()));
+        HELPER_TEST_ASSERT(not tuner.settled())
+        size_t const best_level = tuner.best_level();
+        HELPER_TEST_ASSERT(best_level < 16)
+        tuner.start(16);
+        HELPER_TEST_EQUALS(tuner.level(),best_level)
+        tune(tuner, peak_at_4);
+        HELPER_TEST_EQUALS(tuner.level(),4)
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_construct());
+        HELPER_TEST_CALL(test_single_level());
+        HELPER_TEST_CALL(test_linear_scaling());
+        HELPER_TEST_CALL(test_interior_peak());
+        HELPER_TEST_CALL(test_flat_throughput());
+        HELPER_TEST_CALL(test_decreasing_throughput());
+        HELPER_TEST_CALL(test_gradual_decline());
+        HELPER_TEST_CALL(test_restart_from_settled());
+        HELPER_TEST_CALL(test_restart_from_unsettled());
+    }
+};
+
+int main() {
+    TestWorkloadConcurrencyTuner().test();
+    return HELPER_TEST_FAILURES;
+}
@@ -0,0 +1,154 @@
+/***************************************************************************
+ *            test_workload_statistics.cpp
+ *
+ *  Copyright  2026  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of BetterThreads, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <thread>
+#include "helper/test.hpp"
+#include "workload_statistics.hpp"
+#include "workload.hpp"
+
+using namespace BetterThreads;
+using namespace std::chrono_literals;
+
+void wait_for(int const& ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+class TestWorkloadStatistics {
+  public:
+
+    void test_empty() {
+        WorkloadStatisticsRecorder recorder;
+        auto statistics = recorder.statistics(0);
+        HELPER_TEST_EQUALS(statistics.num_completed,0)
+        HELPER_TEST_ASSERT(statistics.eta == 0ns)
+        statistics = recorder.statistics(3);
+        HELPER_TEST_ASSERT(statistics.eta == WORKLOAD_UNKNOWN_ETA)
+    }
+
+    void test_element_times() {
+        WorkloadStatisticsRecorder recorder;
+        recorder.start(2);
+        auto const now = std::chrono::steady_clock::now();
+        for (int i=0; i<99; ++i) recorder.record(1ms, 1, now);
+        recorder.record(40ms, 4, now);
+        auto const statistics = recorder.statistics(10);
+        HELPER_TEST_EQUALS(statistics.num_completed,103)
+        HELPER_TEST_ASSERT(statistics.min_element_time == 1ms)
+        HELPER_TEST_ASSERT(statistics.max_element_time == 10ms)
+        HELPER_TEST_ASSERT(statistics.mean_element_time > 1ms and statistics.mean_element_time < 2ms)
+        HELPER_TEST_ASSERT(statistics.p95_element_time >= 1ms and statistics.p95_element_time < 1200us)
+        HELPER_TEST_ASSERT(statistics.throughput > 0.0)
+        HELPER_TEST_ASSERT(statistics.eta != WORKLOAD_UNKNOWN_ETA)
+    }
+
+    void test_restart() {
+        WorkloadStatisticsRecorder recorder;
+        recorder.record(5ms, 5, std::chrono::steady_clock::now());
+        recorder.start(1);
+        HELPER_TEST_EQUALS(recorder.statistics(0).num_completed,0)
+        HELPER_TEST_FAIL(recorder.start(0))
+    }
+
+    void test_finish() {
+        WorkloadStatisticsRecorder recorder;
+        recorder.record(5ms, 5, std::chrono::steady_clock::now());
+        recorder.finish();
+        auto const statistics = recorder.statistics(0);
+        std::this_thread::sleep_for(20ms);
+        auto const later_statistics = recorder.statistics(0);
+        HELPER_TEST_ASSERT(later_statistics.elapsed == statistics.elapsed)
+        HELPER_TEST_EQUALS(later_statistics.utilisation,statistics.utilisation)
+        HELPER_TEST_EQUALS(later_statistics.throughput,statistics.throughput)
+        // Restarting measures the elapsed time again
+        recorder.start(1);
+        auto const restarted_elapsed = recorder.statistics(0).elapsed;
+        std::this_thread::sleep_for(5ms);
+        HELPER_TEST_ASSERT(recorder.statistics(0).elapsed >= restarted_elapsed + 5ms)
+    }
+
+    void test_throughput_sampling() {
+        WorkloadStatisticsRecorder recorder;
+        auto const start = std::chrono::steady_clock::now();
+        recorder.record(1ms, 10, start);
+        recorder.record(1ms, 10, start+2s);
+        auto const statistics = recorder.statistics(40);
+        HELPER_TEST_ASSERT(statistics.throughput > 9.0 and statistics.throughput <= 10.0)
+        HELPER_TEST_ASSERT(statistics.eta >= 4s and statistics.eta < 5s)
+    }
+
+    void test_workload_statistics() {
+        ThreadManager::instance().set_concurrency(1);
+        StaticWorkload<int> wl(&wait_for);
+        for (int i=0; i<20; ++i) wl.append(5);
+        wl.process();
+        auto const statistics = wl.statistics();
+        HELPER_TEST_EQUALS(statistics.num_completed,20)
+        HELPER_TEST_ASSERT(statistics.min_element_time >= 5ms)
+        HELPER_TEST_ASSERT(statistics.elapsed >= 50ms)
+        HELPER_TEST_ASSERT(statistics.utilisation > 0.5 and statistics.utilisation <= 1.0)
+        HELPER_TEST_ASSERT(statistics.eta == 0ns)
+        // The statistics of the last processing do not change after it ends
+        std::this_thread::sleep_for(50ms);
+        auto const later_statistics = wl.statistics();
+        HELPER_TEST_ASSERT(later_statistics.elapsed == statistics.elapsed)
+        HELPER_TEST_EQUALS(later_statistics.utilisation,statistics.utilisation)
+    }
+
+    void test_progress_summary() {
+        WorkloadStatistics statistics;
+        statistics.throughput = 12.34;
+        HELPER_TEST_EQUALS(progress_summary(statistics),"12.3/s")
+        statistics.eta = 3500ms;
+        HELPER_TEST_EQUALS(progress_summary(statistics),"12.3/s eta=3s")
+    }
+
+    void test_show_statistics() {
+        StaticWorkload<int> wl(&wait_for);
+        HELPER_TEST_ASSERT(not wl.shows_statistics())
+        wl.set_show_statistics(true);
+        HELPER_TEST_ASSERT(wl.shows_statistics())
+        wl.set_show_statistics(false);
+        HELPER_TEST_ASSERT(not wl.shows_statistics())
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_empty());
+        HELPER_TEST_CALL(test_element_times());
+        HELPER_TEST_CALL(test_restart());
+        HELPER_TEST_CALL(test_finish());
+        HELPER_TEST_CALL(test_throughput_sampling());
+        HELPER_TEST_CALL(test_workload_statistics());
+        HELPER_TEST_CALL(test_progress_summary());
+        HELPER_TEST_CALL(test_show_statistics());
+    }
+};
+
+int main() {
+    TestWorkloadStatistics().test();
+    return HELPER_TEST_FAILURES;
+}